@@ -0,0 +1,224 @@
+// Benchmark harness for the offline render path. Loads a plugin, renders
+// deterministic test signals (impulse train, seeded noise, sine sweep) at a
+// couple of lengths while sweeping the block size over 64-8192, and prints
+// one JSON document with per-configuration throughput (xRealtime), per-block
+// latency percentiles and peak RSS. Run before every plugin or host upgrade:
+//
+//   VSTHostBench --plugin <plugin.vst3> [--sample-rate 48000] [--seconds 1,10]
+
+#include "HostCore.h"
+
+#include <juce_events/juce_events.h>
+
+#include <algorithm>
+#include <iostream>
+
+#if JUCE_WINDOWS
+ #include <windows.h>
+ #include <psapi.h>
+#else
+ #include <sys/resource.h>
+#endif
+
+namespace vsthost
+{
+
+static juce::int64 getPeakRssBytes()
+{
+#if JUCE_WINDOWS
+    PROCESS_MEMORY_COUNTERS counters {};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return static_cast<juce::int64>(counters.PeakWorkingSetSize);
+    return 0;
+#else
+    rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+ #if JUCE_MAC
+    return static_cast<juce::int64>(usage.ru_maxrss); // bytes on macOS
+ #else
+    return static_cast<juce::int64>(usage.ru_maxrss) * 1024; // KiB on Linux
+ #endif
+#endif
+}
+
+// All signals are fully deterministic so runs are comparable across machines
+// and upgrades.
+static void fillTestSignal(juce::AudioBuffer<float>& buffer, const juce::String& signal, double sampleRate)
+{
+    const int numSamples = buffer.getNumSamples();
+    buffer.clear();
+
+    if (signal == "impulse")
+    {
+        // One unit impulse every 100 ms: wakes envelopes up, then lets any
+        // denormal-prone tail decay between hits.
+        const int period = juce::jmax(1, static_cast<int>(sampleRate * 0.1));
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer(ch);
+            for (int i = 0; i < numSamples; i += period)
+                data[i] = 1.0f;
+        }
+    }
+    else if (signal == "noise")
+    {
+        juce::Random random(0x5eed);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer(ch);
+            for (int i = 0; i < numSamples; ++i)
+                data[i] = random.nextFloat() * 0.5f - 0.25f;
+        }
+    }
+    else // sweep: 20 Hz to Nyquist/2, exponential
+    {
+        const double f0 = 20.0;
+        const double f1 = sampleRate * 0.25;
+        const double k = std::log(f1 / f0) / juce::jmax(1, numSamples - 1);
+        double phase = 0.0;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float sample = 0.5f * static_cast<float>(std::sin(phase));
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.setSample(ch, i, sample);
+            phase += juce::MathConstants<double>::twoPi * f0 * std::exp(k * i) / sampleRate;
+        }
+    }
+}
+
+static double percentileMs(std::vector<double>& sortedMs, double fraction)
+{
+    if (sortedMs.empty())
+        return 0.0;
+
+    const auto index = static_cast<size_t>(fraction * static_cast<double>(sortedMs.size() - 1) + 0.5);
+    return sortedMs[juce::jmin(index, sortedMs.size() - 1)];
+}
+
+// Runs the prepared plugin over the signal at one block size and reports
+// wall-clock throughput plus per-processBlock latency percentiles.
+static juce::var benchOneConfiguration(juce::AudioPluginInstance& plugin,
+                                       const juce::AudioBuffer<float>& signal,
+                                       const juce::String& signalName,
+                                       double sampleRate,
+                                       int blockSize)
+{
+    const int numChannels = signal.getNumChannels();
+    const int numSamples = signal.getNumSamples();
+
+    plugin.setNonRealtime(true);
+    plugin.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+    plugin.prepareToPlay(sampleRate, blockSize);
+    plugin.reset();
+    plugin.suspendProcessing(false);
+
+    juce::AudioBuffer<float> block(numChannels, blockSize);
+    juce::MidiBuffer midi;
+
+    std::vector<double> blockMs;
+    blockMs.reserve(static_cast<size_t>(numSamples / blockSize + 1));
+
+    const double startMs = juce::Time::getMillisecondCounterHiRes();
+
+    for (int position = 0; position < numSamples; position += blockSize)
+    {
+        const int numThisTime = juce::jmin(blockSize, numSamples - position);
+
+        block.clear();
+        for (int ch = 0; ch < numChannels; ++ch)
+            block.copyFrom(ch, 0, signal, ch, position, numThisTime);
+
+        juce::AudioBuffer<float> view(block.getArrayOfWritePointers(), numChannels, numThisTime);
+
+        const double blockStartMs = juce::Time::getMillisecondCounterHiRes();
+        plugin.processBlock(view, midi);
+        blockMs.push_back(juce::Time::getMillisecondCounterHiRes() - blockStartMs);
+    }
+
+    const double elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+
+    plugin.releaseResources();
+
+    std::sort(blockMs.begin(), blockMs.end());
+
+    auto result = std::make_unique<juce::DynamicObject>();
+    result->setProperty("signal", signalName);
+    result->setProperty("seconds", numSamples / sampleRate);
+    result->setProperty("blockSize", blockSize);
+    result->setProperty("xRealtime", elapsedSeconds > 0.0
+                                         ? (numSamples / sampleRate) / elapsedSeconds
+                                         : 0.0);
+    result->setProperty("p50BlockMs", percentileMs(blockMs, 0.50));
+    result->setProperty("p99BlockMs", percentileMs(blockMs, 0.99));
+    result->setProperty("maxBlockMs", blockMs.empty() ? 0.0 : blockMs.back());
+    return juce::var(result.release());
+}
+
+static int runBench(const juce::ArgumentList& args)
+{
+    const auto pluginPath = args.getValueForOption("--plugin");
+    if (pluginPath.isEmpty())
+    {
+        std::cerr << "Usage: VSTHostBench --plugin <plugin.vst3> [--sample-rate 48000] [--seconds 1,10]\n";
+        return 2;
+    }
+
+    double sampleRate = 48000.0;
+    if (args.containsOption("--sample-rate"))
+        sampleRate = juce::jmax(8000.0, args.getValueForOption("--sample-rate").getDoubleValue());
+
+    juce::Array<double> lengthsSeconds { 1.0, 10.0 };
+    if (args.containsOption("--seconds"))
+    {
+        lengthsSeconds.clear();
+        for (const auto& token : juce::StringArray::fromTokens(args.getValueForOption("--seconds"), ",", {}))
+            if (token.getDoubleValue() > 0.0)
+                lengthsSeconds.add(token.getDoubleValue());
+    }
+
+    PluginHost host;
+    juce::String error;
+    if (!host.loadPluginFromFile(juce::File::getCurrentWorkingDirectory().getChildFile(pluginPath),
+                                 sampleRate, 1024, error))
+    {
+        std::cerr << error.toStdString() << "\n";
+        return 1;
+    }
+
+    auto* plugin = host.get();
+    const int numChannels = plugin->getTotalNumOutputChannels() >= 2 ? 2 : 1;
+
+    juce::Array<juce::var> results;
+
+    for (const auto& signalName : { juce::String("impulse"), juce::String("noise"), juce::String("sweep") })
+    {
+        for (auto seconds : lengthsSeconds)
+        {
+            juce::AudioBuffer<float> signal(numChannels, static_cast<int>(seconds * sampleRate));
+            fillTestSignal(signal, signalName, sampleRate);
+
+            for (int blockSize = 64; blockSize <= 8192; blockSize *= 2)
+                results.add(benchOneConfiguration(*plugin, signal, signalName, sampleRate, blockSize));
+        }
+    }
+
+    auto report = std::make_unique<juce::DynamicObject>();
+    report->setProperty("plugin", plugin->getName());
+    report->setProperty("sampleRate", sampleRate);
+    report->setProperty("peakRssBytes", getPeakRssBytes());
+    report->setProperty("results", results);
+
+    std::cout << juce::JSON::toString(juce::var(report.release())) << "\n";
+    return 0;
+}
+
+} // namespace vsthost
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit; // VST3 loading needs the message thread
+
+    juce::ArgumentList args(argc, argv);
+    return vsthost::runBench(args);
+}
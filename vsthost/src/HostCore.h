@@ -0,0 +1,2125 @@
+// Shared host core: plugin loading/instantiation and the offline render
+// engine, pulled out of Main.cpp so the benchmark harness can drive the
+// exact code the app ships without linking the GUI.
+
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+static juce::String u8str(const char* s)
+{
+    return juce::String::fromUTF8(s);
+}
+
+namespace vsthost
+{
+class PluginHost
+{
+public:
+    PluginHost()
+    {
+        formatManager.addDefaultFormats();
+    }
+
+    // stateFile optionally restores a blob captured by savePluginState
+    // immediately after instantiation, so unattended runs start from the
+    // tuned settings instead of the plugin's defaults.
+    bool loadPluginFromFile(const juce::File& pluginFile, double sampleRate, int blockSize, juce::String& error,
+                            const juce::File& stateFile = {})
+    {
+        unloadPlugin();
+
+        juce::PluginDescription description;
+        if (!findDescriptionForFile(pluginFile, description, error))
+            return false;
+
+        pluginDescription = description;
+
+        std::unique_ptr<juce::AudioPluginInstance> instance(
+            formatManager.createPluginInstance(pluginDescription, sampleRate, blockSize, error));
+
+        if (instance == nullptr)
+            return false;
+
+        pluginInstance = std::move(instance);
+
+        if (stateFile != juce::File() && !loadPluginState(stateFile, error))
+        {
+            unloadPlugin();
+            return false;
+        }
+
+        return true;
+    }
+
+    // Captures the loaded plugin's full state blob to a file. Restoring it
+    // later takes milliseconds versus minutes of GUI recall, and is what
+    // makes unattended batch rendering reproducible.
+    bool savePluginState(const juce::File& stateFile, juce::String& error)
+    {
+        if (pluginInstance == nullptr)
+        {
+            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
+            return false;
+        }
+
+        juce::MemoryBlock state;
+        pluginInstance->getStateInformation(state);
+        if (state.getSize() == 0)
+        {
+            error = u8str(u8"\u63d2\u4ef6\u6ca1\u6709\u53ef\u4fdd\u5b58\u7684\u72b6\u6001");
+            return false;
+        }
+
+        stateFile.getParentDirectory().createDirectory();
+        if (!stateFile.replaceWithData(state.getData(), state.getSize()))
+        {
+            error = u8str(u8"\u65e0\u6cd5\u5199\u5165\u72b6\u6001\u6587\u4ef6");
+            return false;
+        }
+
+        return true;
+    }
+
+    // Applies a saved blob to the loaded plugin and remembers it, so clones
+    // handed out for batch/parallel work inherit the same tuned settings.
+    bool loadPluginState(const juce::File& stateFile, juce::String& error)
+    {
+        if (pluginInstance == nullptr)
+        {
+            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
+            return false;
+        }
+
+        juce::MemoryBlock state;
+        if (!stateFile.loadFileAsData(state) || state.getSize() == 0)
+        {
+            error = u8str(u8"\u65e0\u6cd5\u8bfb\u53d6\u72b6\u6001\u6587\u4ef6");
+            return false;
+        }
+
+        pluginInstance->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        savedState = std::move(state);
+        return true;
+    }
+
+    void unloadPlugin()
+    {
+        if (pluginInstance != nullptr)
+            pluginInstance->releaseResources();
+
+        for (auto& chained : chainInstances)
+            chained->releaseResources();
+
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            for (auto& pooled : pooledInstances)
+                pooled->releaseResources();
+            pooledInstances.clear();
+        }
+
+        chainInstances.clear();
+        pluginInstance.reset();
+        pluginDescription = {};
+        savedState.setSize(0);
+    }
+
+    // Appends another plugin after the loaded one. The whole chain runs per
+    // block in float inside the render loop, so multi-stage recipes
+    // (gate -> EQ -> limiter) no longer round-trip through intermediate WAVs.
+    bool addPluginToChain(const juce::File& pluginFile, double sampleRate, int blockSize, juce::String& error)
+    {
+        if (pluginInstance == nullptr)
+        {
+            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
+            return false;
+        }
+
+        juce::PluginDescription description;
+        if (!findDescriptionForFile(pluginFile, description, error))
+            return false;
+
+        auto instance = formatManager.createPluginInstance(description, sampleRate, blockSize, error);
+        if (instance == nullptr)
+            return false;
+
+        chainInstances.push_back(std::move(instance));
+        return true;
+    }
+
+    // Loaded plugin first, then the chained ones, in processing order.
+    std::vector<juce::AudioPluginInstance*> getChain() const
+    {
+        std::vector<juce::AudioPluginInstance*> chain;
+        if (pluginInstance != nullptr)
+        {
+            chain.push_back(pluginInstance.get());
+            for (auto& chained : chainInstances)
+                chain.push_back(chained.get());
+        }
+        return chain;
+    }
+
+    juce::StringArray getChainNames() const
+    {
+        juce::StringArray names;
+        if (pluginInstance != nullptr)
+        {
+            names.add(pluginDescription.name);
+            for (auto& chained : chainInstances)
+                names.add(chained->getName());
+        }
+        return names;
+    }
+
+    // Creates another instance of the already-resolved plugin, skipping the
+    // file scan. Used by the batch engine to run renders in parallel.
+    std::unique_ptr<juce::AudioPluginInstance> createAdditionalInstance(double sampleRate, int blockSize, juce::String& error)
+    {
+        if (pluginInstance == nullptr)
+        {
+            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
+            return nullptr;
+        }
+
+        auto instance = formatManager.createPluginInstance(pluginDescription, sampleRate, blockSize, error);
+        if (instance != nullptr && savedState.getSize() > 0)
+            instance->setStateInformation(savedState.getData(), static_cast<int>(savedState.getSize()));
+        return instance;
+    }
+
+    // Warm instance pool. VST3 instantiation is message-thread-only, so the
+    // instances are created serially on the calling thread; only
+    // prepareToPlay - where big samplers actually load their content - runs
+    // concurrently in background threads. Render jobs then acquire a ready
+    // instance in O(1) instead of paying seconds of cold instantiation.
+    bool prewarmInstances(int count, double sampleRate, int blockSize, juce::String& error)
+    {
+        if (pluginInstance == nullptr)
+        {
+            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
+            return false;
+        }
+
+        std::vector<std::unique_ptr<juce::AudioPluginInstance>> fresh;
+        for (int i = 0; i < count; ++i)
+        {
+            auto instance = formatManager.createPluginInstance(pluginDescription, sampleRate, blockSize, error);
+            if (instance == nullptr)
+                return false;
+            if (savedState.getSize() > 0)
+                instance->setStateInformation(savedState.getData(), static_cast<int>(savedState.getSize()));
+            fresh.push_back(std::move(instance));
+        }
+
+        {
+            juce::ThreadPool preparePool(juce::jlimit(1, juce::SystemStats::getNumCpus(), count));
+            for (auto& instance : fresh)
+            {
+                auto* plugin = instance.get();
+                preparePool.addJob([plugin, sampleRate, blockSize]
+                {
+                    plugin->setNonRealtime(true);
+                    plugin->prepareToPlay(sampleRate, blockSize);
+                });
+            }
+
+            while (preparePool.getNumJobs() > 0)
+                juce::Thread::sleep(10);
+        }
+
+        std::lock_guard<std::mutex> lock(poolMutex);
+        for (auto& instance : fresh)
+            pooledInstances.push_back(std::move(instance));
+        return true;
+    }
+
+    // Pops a prewarmed instance, or instantiates a cold one when the pool is
+    // dry. Callers re-prepare for their own configuration either way.
+    std::unique_ptr<juce::AudioPluginInstance> acquireInstance(double sampleRate, int blockSize, juce::String& error)
+    {
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            if (!pooledInstances.empty())
+            {
+                auto instance = std::move(pooledInstances.back());
+                pooledInstances.pop_back();
+                return instance;
+            }
+        }
+
+        return createAdditionalInstance(sampleRate, blockSize, error);
+    }
+
+    // Returns an instance to the pool so the next job skips instantiation.
+    void releaseInstance(std::unique_ptr<juce::AudioPluginInstance> instance)
+    {
+        if (instance == nullptr)
+            return;
+
+        std::lock_guard<std::mutex> lock(poolMutex);
+        pooledInstances.push_back(std::move(instance));
+    }
+
+    juce::AudioPluginInstance* get() const { return pluginInstance.get(); }
+    const juce::PluginDescription& getDescription() const { return pluginDescription; }
+
+private:
+    // Scan results are persisted in a KnownPluginList keyed by file path and
+    // modification time, so repeat loads of the same bundle skip the slow
+    // findAllTypesForFile introspection and go straight to instantiation.
+    bool findDescriptionForFile(const juce::File& pluginFile, juce::PluginDescription& result, juce::String& error)
+    {
+        const auto path = pluginFile.getFullPathName();
+        const auto modTime = pluginFile.getLastModificationTime();
+
+        if (!cacheLoaded)
+        {
+            cacheLoaded = true;
+            if (auto xml = juce::parseXML(getScanCacheFile()))
+                knownPlugins.recreateFromXml(*xml);
+        }
+
+        for (const auto& type : knownPlugins.getTypes())
+        {
+            if (type.fileOrIdentifier == path && type.lastFileModTime == modTime)
+            {
+                result = type;
+                return true;
+            }
+        }
+
+        juce::OwnedArray<juce::PluginDescription> types;
+        for (auto* format : formatManager.getFormats())
+        {
+            format->findAllTypesForFile(types, path);
+            if (!types.isEmpty())
+                break;
+        }
+
+        if (types.isEmpty())
+        {
+            error = u8str(u8"\u6ca1\u6709\u8bc6\u522b\u5230\u53ef\u52a0\u8f7d\u7684\u63d2\u4ef6\u7c7b\u578b\uff08\u4ec5\u652f\u6301\u5df2\u542f\u7528\u7684\u683c\u5f0f\uff0c\u5982 VST3\uff09");
+            return false;
+        }
+
+        for (const auto* type : types)
+            knownPlugins.addType(*type);
+
+        if (auto xml = knownPlugins.createXml())
+        {
+            const auto cacheFile = getScanCacheFile();
+            cacheFile.getParentDirectory().createDirectory();
+            xml->writeTo(cacheFile);
+        }
+
+        result = *types.getFirst();
+        return true;
+    }
+
+    static juce::File getScanCacheFile()
+    {
+        return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                   .getChildFile("VSTHostApp")
+                   .getChildFile("plugin_scan_cache.xml");
+    }
+
+    juce::AudioPluginFormatManager formatManager;
+    juce::PluginDescription pluginDescription;
+    std::unique_ptr<juce::AudioPluginInstance> pluginInstance;
+    std::vector<std::unique_ptr<juce::AudioPluginInstance>> chainInstances;
+    juce::KnownPluginList knownPlugins;
+    bool cacheLoaded = false;
+
+    std::vector<std::unique_ptr<juce::AudioPluginInstance>> pooledInstances;
+    std::mutex poolMutex;
+    juce::MemoryBlock savedState; // applied to every new instance once loaded
+};
+
+class OfflineProcessor
+{
+public:
+    explicit OfflineProcessor(PluginHost& hostToUse) : host(hostToUse) {}
+
+    // Per-stage block timing as a power-of-two microsecond histogram:
+    // recording is one increment, and percentiles come back with bucket
+    // resolution - plenty to spot a plugin whose p99 is 50x its median.
+    struct StageTiming
+    {
+        static constexpr int numBuckets = 24; // 1 us .. ~8 s per block
+
+        juce::int64 counts[numBuckets] = {};
+        juce::int64 numBlocks = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+
+        void record(double ms)
+        {
+            auto us = static_cast<juce::int64>(ms * 1000.0);
+            int bucket = 0;
+            while (us > 1 && bucket < numBuckets - 1)
+            {
+                us >>= 1;
+                ++bucket;
+            }
+
+            ++counts[bucket];
+            ++numBlocks;
+            totalMs += ms;
+            maxMs = juce::jmax(maxMs, ms);
+        }
+
+        // Upper bound of the bucket containing the requested fraction,
+        // clamped to the observed maximum so a sparse top bucket cannot
+        // report a percentile beyond any block actually seen.
+        double percentileMs(double fraction) const
+        {
+            const auto target = static_cast<juce::int64>(fraction * static_cast<double>(numBlocks));
+            juce::int64 seen = 0;
+            for (int bucket = 0; bucket < numBuckets; ++bucket)
+            {
+                seen += counts[bucket];
+                if (seen > target)
+                    return juce::jmin(maxMs, static_cast<double>(1LL << (bucket + 1)) * 0.001);
+            }
+            return maxMs;
+        }
+    };
+
+    struct ProcessStats
+    {
+        double inputRmsDb = 0.0;
+        double diffRmsDb = 0.0;
+        float maxAbsDiff = 0.0f;
+        float outputPeak = 0.0f;         // absolute peak before any normalization
+        juce::int64 clippedSamples = 0;  // samples beyond full scale before normalization
+        int outputChannels = 0;
+
+        StageTiming readTiming;    // reader->read + channel fixup
+        StageTiming processTiming; // the plugin chain's processBlock calls
+        StageTiming writeTiming;   // writeFromAudioSampleBuffer
+    };
+
+    // One point of an automation lane. Points are applied to the first
+    // plugin in the chain between processBlock calls, so a cleaning recipe
+    // can sweep threshold or mix across the file without re-preparing
+    // anything. Values are normalized 0..1, as seen by setValue.
+    struct AutomationPoint
+    {
+        int parameterIndex = 0;
+        double timeSeconds = 0.0;
+        float value = 0.0f;
+    };
+
+    void setAutomationPoints(std::vector<AutomationPoint> points)
+    {
+        std::sort(points.begin(), points.end(),
+                  [](const AutomationPoint& a, const AutomationPoint& b) { return a.timeSeconds < b.timeSeconds; });
+        automationPoints = std::move(points);
+    }
+
+    void clearAutomationPoints() { automationPoints.clear(); }
+
+    // Called from the processing thread after each block: frames rendered so
+    // far, total frames, and the current realtime factor (rendered samples
+    // per wall second divided by the sample rate).
+    using ProgressCallback = std::function<void(juce::int64 framesDone, juce::int64 totalFrames, double xRealtime)>;
+
+    bool processAudioFileToFile(const juce::File& inputFile,
+                                const juce::File& outputWavFile,
+                                juce::String& error,
+                                ProcessStats* stats = nullptr,
+                                const ProgressCallback& progress = {})
+    {
+        if (!statsEnabled)
+            stats = nullptr;
+
+        const auto chain = host.getChain();
+        if (chain.empty())
+        {
+            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
+            return false;
+        }
+
+        endArraySession(); // the file path reconfigures the plugins below
+        return renderFile(chain, lastBlockSize, inputFile, outputWavFile, error, stats, progress, outputBitDepth,
+                          automationPoints, targetSampleRate, normalizeEnabled);
+    }
+
+    static bool renderFile(juce::AudioPluginInstance& plugin,
+                           int blockSize,
+                           const juce::File& inputFile,
+                           const juce::File& outputWavFile,
+                           juce::String& error,
+                           ProcessStats* stats = nullptr,
+                           const ProgressCallback& progress = {},
+                           int bitDepth = 24)
+    {
+        return renderFile(std::vector<juce::AudioPluginInstance*> { &plugin },
+                          blockSize, inputFile, outputWavFile, error, stats, progress, bitDepth, {});
+    }
+
+    // Core of the offline file render, written against a plain list of plugin
+    // instances: the batch engine passes one clone per worker, and chained
+    // plugins run back to back on each block in float, so multi-stage recipes
+    // write only the final result. bitDepth is 16/24 for integer WAV or 32
+    // for float32, which makes the write path a near-memcpy.
+    static bool renderFile(const std::vector<juce::AudioPluginInstance*>& chain,
+                           int blockSize,
+                           const juce::File& inputFile,
+                           const juce::File& outputWavFile,
+                           juce::String& error,
+                           ProcessStats* stats = nullptr,
+                           const ProgressCallback& progress = {},
+                           int bitDepth = 24,
+                           const std::vector<AutomationPoint>& automation = {},
+                           double targetSampleRate = 0.0,
+                           bool normalize = false)
+    {
+        if (!isSupportedBitDepth(bitDepth))
+        {
+            error = u8str(u8"\u4e0d\u652f\u6301\u7684\u8f93\u51fa\u4f4d\u6df1\u5ea6\uff08\u4ec5\u652f\u6301 16/24/32\uff09");
+            return false;
+        }
+
+        if (chain.empty())
+        {
+            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
+            return false;
+        }
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        auto reader = createBestReaderFor(formatManager, inputFile);
+        if (reader == nullptr)
+        {
+            error = u8str(u8"\u65e0\u6cd5\u8bfb\u53d6\u8f93\u5165\u97f3\u9891\u6587\u4ef6");
+            return false;
+        }
+
+        // When a target rate is set the reader thread resamples each block on
+        // the way in, so the plugins and the writer both run at the target
+        // rate and the file is converted in the same pass that renders it.
+        const double inputRate = reader->sampleRate;
+        const bool resampling = targetSampleRate > 0.0 && std::abs(targetSampleRate - inputRate) > 0.01;
+        const double sampleRate = resampling ? targetSampleRate : inputRate;
+        const double resampleRatio = inputRate / sampleRate; // input frames per output frame
+        const auto numSamples64 = resampling
+                                      ? static_cast<juce::int64>(std::llround(
+                                            static_cast<double>(reader->lengthInSamples) / resampleRatio))
+                                      : reader->lengthInSamples;
+        const int numInputChannels = static_cast<int>(reader->numChannels);
+
+        const int desiredBlockSize = juce::jlimit(64, 8192, blockSize);
+
+        int numPluginIns = 1;
+        int numPluginOuts = 1;
+        for (auto* plugin : chain)
+        {
+            numPluginIns = juce::jmax(numPluginIns, plugin->getTotalNumInputChannels());
+            numPluginOuts = juce::jmax(numPluginOuts, plugin->getTotalNumOutputChannels());
+        }
+
+        int processChannels = numInputChannels;
+
+        if (numInputChannels == 1 && numPluginOuts >= 2)
+            processChannels = 2;
+
+        if (stats != nullptr)
+            stats->outputChannels = processChannels;
+
+        for (auto* plugin : chain)
+        {
+            plugin->setNonRealtime(true);
+            plugin->setPlayConfigDetails(processChannels, processChannels, sampleRate, desiredBlockSize);
+            plugin->prepareToPlay(sampleRate, desiredBlockSize);
+            plugin->reset();
+            plugin->suspendProcessing(false);
+        }
+
+        const int bufferChannels = juce::jmax(processChannels, juce::jmax(numPluginIns, numPluginOuts));
+
+        outputWavFile.getParentDirectory().createDirectory();
+
+        // When normalizing, the first pass lands in a float32 WAV scratch:
+        // integer (and FLAC) writers saturate at full scale, which would
+        // clip exactly the blocks normalization exists to rescue. The
+        // requested codec and bit depth are produced by the gain pass below.
+        const auto renderTarget = normalize ? outputWavFile.withFileExtension("wav") : outputWavFile;
+        juce::TemporaryFile tempFile(renderTarget);
+
+        std::unique_ptr<juce::FileOutputStream> outputStream(tempFile.getFile().createOutputStream());
+        if (outputStream == nullptr || !outputStream->openedOk())
+        {
+            error = u8str(u8"\u65e0\u6cd5\u521b\u5efa\u8f93\u51fa\u6587\u4ef6\u6d41");
+            releaseChain(chain);
+            return false;
+        }
+
+        auto writer = createWriterForOutput(renderTarget, std::move(outputStream),
+                                            sampleRate, processChannels, normalize ? 32 : bitDepth);
+        if (writer == nullptr)
+        {
+            error = u8str(u8"\u65e0\u6cd5\u521b\u5efa\u97f3\u9891\u5199\u5165\u5668");
+            releaseChain(chain);
+            return false;
+        }
+
+        // Three-stage pipeline over a small ring of blocks: a reader thread
+        // decodes ahead of the plugin and a writer thread encodes behind it,
+        // so disk and sample packing overlap processBlock instead of
+        // serializing with it.
+        constexpr int numSlots = 4;
+        BlockSlot slots[numSlots];
+        for (auto& slot : slots)
+            slot.buffer.setSize(bufferChannels, desiredBlockSize);
+
+        SlotQueue freeSlots, filledSlots, processedSlots;
+        for (int i = 0; i < numSlots; ++i)
+            freeSlots.push(i);
+
+        std::atomic<bool> writeFailed { false };
+
+        // Each struct is written by exactly one pipeline thread and folded
+        // into stats only after both joins.
+        StageTiming readTiming, processTiming, writeTiming;
+
+        std::thread readerThread([&]
+        {
+            if (resampling)
+            {
+                // Source frames are staged at the input rate and pulled
+                // through one Lagrange interpolator per channel, so each slot
+                // leaves here already at the target rate. The staging buffer
+                // holds at most one output block's worth of input plus the
+                // few frames of interpolator history.
+                std::vector<juce::LagrangeInterpolator> interpolators(static_cast<size_t>(processChannels));
+                const int stagingCapacity = static_cast<int>(std::ceil(desiredBlockSize * resampleRatio)) + 64;
+                juce::AudioBuffer<float> staging(processChannels, stagingCapacity);
+                staging.clear();
+
+                int64_t inputPosition = 0;
+                int64_t outputPosition = 0;
+                int staged = 0;
+
+                while (outputPosition < numSamples64 && !writeFailed.load())
+                {
+                    const int slotIndex = freeSlots.pop();
+                    if (slotIndex < 0)
+                        break;
+
+                    auto& slot = slots[slotIndex];
+                    const int numThisTime = static_cast<int>(juce::jmin<int64_t>(desiredBlockSize, numSamples64 - outputPosition));
+
+                    const double blockStartMs = stats != nullptr ? juce::Time::getMillisecondCounterHiRes() : 0.0;
+
+                    const int wanted = static_cast<int>(std::ceil(numThisTime * resampleRatio)) + 8;
+                    while (staged < wanted)
+                    {
+                        const int toRead = static_cast<int>(juce::jmin<int64_t>(stagingCapacity - staged,
+                                                                                reader->lengthInSamples - inputPosition));
+                        if (toRead <= 0)
+                        {
+                            // Input exhausted: pad with silence so the last
+                            // output block can flush the interpolators.
+                            staging.clear(staged, wanted - staged);
+                            staged = wanted;
+                            break;
+                        }
+
+                        reader->read(&staging, staged, toRead, inputPosition, true, true);
+
+                        if (numInputChannels == 1 && processChannels == 2)
+                            staging.copyFrom(1, staged, staging, 0, staged, toRead);
+
+                        inputPosition += toRead;
+                        staged += toRead;
+                    }
+
+                    slot.buffer.clear();
+                    int consumed = 0;
+                    for (int ch = 0; ch < processChannels; ++ch)
+                        consumed = interpolators[static_cast<size_t>(ch)].process(resampleRatio,
+                                                                                  staging.getReadPointer(ch),
+                                                                                  slot.buffer.getWritePointer(ch),
+                                                                                  numThisTime);
+
+                    staged -= consumed;
+                    for (int ch = 0; ch < processChannels; ++ch)
+                        std::memmove(staging.getWritePointer(ch),
+                                     staging.getReadPointer(ch) + consumed,
+                                     static_cast<size_t>(staged) * sizeof(float));
+
+                    if (stats != nullptr)
+                        readTiming.record(juce::Time::getMillisecondCounterHiRes() - blockStartMs);
+
+                    slot.numSamples = numThisTime;
+                    outputPosition += numThisTime;
+                    filledSlots.push(slotIndex);
+                }
+
+                filledSlots.finish();
+                return;
+            }
+
+            int64_t position = 0;
+            while (position < numSamples64 && !writeFailed.load())
+            {
+                const int slotIndex = freeSlots.pop();
+                if (slotIndex < 0)
+                    break;
+
+                auto& slot = slots[slotIndex];
+                const int numThisTime = static_cast<int>(juce::jmin<int64_t>(desiredBlockSize, numSamples64 - position));
+
+                const double blockStartMs = stats != nullptr ? juce::Time::getMillisecondCounterHiRes() : 0.0;
+
+                slot.buffer.clear();
+                reader->read(&slot.buffer, 0, numThisTime, position, true, true);
+
+                if (numInputChannels == 1 && processChannels == 2)
+                    slot.buffer.copyFrom(1, 0, slot.buffer, 0, 0, numThisTime);
+
+                if (stats != nullptr)
+                    readTiming.record(juce::Time::getMillisecondCounterHiRes() - blockStartMs);
+
+                slot.numSamples = numThisTime;
+                position += numThisTime;
+                filledSlots.push(slotIndex);
+            }
+
+            filledSlots.finish();
+        });
+
+        std::thread writerThread([&]
+        {
+            for (;;)
+            {
+                const int slotIndex = processedSlots.pop();
+                if (slotIndex < 0)
+                    break;
+
+                auto& slot = slots[slotIndex];
+
+                const double blockStartMs = stats != nullptr ? juce::Time::getMillisecondCounterHiRes() : 0.0;
+
+                if (!writer->writeFromAudioSampleBuffer(slot.buffer, 0, slot.numSamples))
+                    writeFailed.store(true); // keep draining so the pipeline can unwind
+
+                if (stats != nullptr)
+                    writeTiming.record(juce::Time::getMillisecondCounterHiRes() - blockStartMs);
+
+                freeSlots.push(slotIndex);
+            }
+        });
+
+        // The dry capture exists only for the stats comparison; the common
+        // path processes in place with no copy at all.
+        juce::AudioBuffer<float> dry, diffScratch;
+        if (stats != nullptr)
+        {
+            dry.setSize(processChannels, desiredBlockSize);
+            diffScratch.setSize(1, desiredBlockSize);
+        }
+
+        juce::MidiBuffer midi;
+
+        double drySumSquares = 0.0;
+        double diffSumSquares = 0.0;
+        float maxAbsDiff = 0.0f;
+        float outputPeak = 0.0f;
+        int64_t clippedSamples = 0;
+        const bool trackPeak = normalize || stats != nullptr;
+        int64_t totalSamples = 0;
+        int64_t framesDone = 0;
+        size_t nextAutomation = 0;
+        const double startMs = juce::Time::getMillisecondCounterHiRes();
+
+        for (;;)
+        {
+            const int slotIndex = filledSlots.pop();
+            if (slotIndex < 0)
+                break;
+
+            auto& slot = slots[slotIndex];
+            const int numThisTime = slot.numSamples;
+
+            if (stats != nullptr)
+                for (int ch = 0; ch < processChannels; ++ch)
+                    dry.copyFrom(ch, 0, slot.buffer, ch, 0, numThisTime);
+
+            // Automation points are sorted by time; apply everything due
+            // before this block ends to the first plugin in the chain.
+            const double blockEndSeconds = static_cast<double>(framesDone + numThisTime) / sampleRate;
+            while (nextAutomation < automation.size()
+                   && automation[nextAutomation].timeSeconds < blockEndSeconds)
+            {
+                const auto& point = automation[nextAutomation++];
+                const auto& parameters = chain.front()->getParameters();
+                if (juce::isPositiveAndBelow(point.parameterIndex, parameters.size()))
+                    parameters[point.parameterIndex]->setValue(juce::jlimit(0.0f, 1.0f, point.value));
+            }
+
+            const double blockStartMs = stats != nullptr ? juce::Time::getMillisecondCounterHiRes() : 0.0;
+
+            for (auto* plugin : chain)
+                plugin->processBlock(slot.buffer, midi);
+
+            // Peak and clip scan piggybacks on the pass that already owns
+            // this block; findMinAndMax is vectorized and the clip count
+            // only walks blocks whose peak actually exceeds full scale.
+            if (trackPeak)
+            {
+                for (int ch = 0; ch < processChannels; ++ch)
+                {
+                    const auto* samples = slot.buffer.getReadPointer(ch);
+                    const auto range = juce::FloatVectorOperations::findMinAndMax(samples, numThisTime);
+                    const float channelPeak = juce::jmax(std::abs(range.getStart()), std::abs(range.getEnd()));
+                    outputPeak = juce::jmax(outputPeak, channelPeak);
+
+                    if (channelPeak > 1.0f)
+                        for (int i = 0; i < numThisTime; ++i)
+                            if (std::abs(samples[i]) > 1.0f)
+                                ++clippedSamples;
+                }
+            }
+
+            if (stats != nullptr)
+            {
+                processTiming.record(juce::Time::getMillisecondCounterHiRes() - blockStartMs);
+
+                for (int ch = 0; ch < processChannels; ++ch)
+                    accumulateBlockStats(dry.getReadPointer(ch), slot.buffer.getReadPointer(ch),
+                                         diffScratch.getWritePointer(0), numThisTime,
+                                         drySumSquares, diffSumSquares, maxAbsDiff);
+
+                totalSamples += static_cast<int64_t>(processChannels) * static_cast<int64_t>(numThisTime);
+            }
+
+            framesDone += numThisTime;
+
+            if (progress != nullptr)
+            {
+                const double elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+                const double xRealtime = elapsedSeconds > 0.0
+                                             ? static_cast<double>(framesDone) / (elapsedSeconds * sampleRate)
+                                             : 0.0;
+                progress(framesDone, numSamples64, xRealtime);
+            }
+
+            processedSlots.push(slotIndex);
+        }
+
+        processedSlots.finish();
+        writerThread.join();
+        freeSlots.finish();
+        readerThread.join();
+
+        if (writeFailed.load())
+        {
+            error = u8str(u8"\u5199\u5165\u8f93\u51fa\u6587\u4ef6\u5931\u8d25");
+            writer.reset();
+            releaseChain(chain);
+            return false;
+        }
+
+        writer.reset();
+
+        // Normalization reuses the peak found during the render: one gain
+        // pass over the float scratch replaces the separate
+        // read-whole-file/find-peak/rewrite step scripts used to run after.
+        // It always runs when requested, since it is also what converts the
+        // scratch to the requested codec and bit depth.
+        bool finalized = false;
+        if (normalize)
+        {
+            const float gain = outputPeak > 0.0f ? 1.0f / outputPeak : 1.0f;
+
+            auto normReader = createBestReaderFor(formatManager, tempFile.getFile());
+            if (normReader == nullptr)
+            {
+                error = u8str(u8"\u65e0\u6cd5\u8bfb\u53d6\u4e34\u65f6\u8f93\u51fa\u6587\u4ef6");
+                releaseChain(chain);
+                return false;
+            }
+
+            juce::TemporaryFile normTemp(outputWavFile);
+            std::unique_ptr<juce::FileOutputStream> normStream(normTemp.getFile().createOutputStream());
+            if (normStream == nullptr || !normStream->openedOk())
+            {
+                error = u8str(u8"\u65e0\u6cd5\u521b\u5efa\u8f93\u51fa\u6587\u4ef6\u6d41");
+                releaseChain(chain);
+                return false;
+            }
+
+            auto normWriter = createWriterForOutput(outputWavFile, std::move(normStream),
+                                                    sampleRate, processChannels, bitDepth);
+            if (normWriter == nullptr)
+            {
+                error = u8str(u8"\u65e0\u6cd5\u521b\u5efa\u97f3\u9891\u5199\u5165\u5668");
+                releaseChain(chain);
+                return false;
+            }
+
+            juce::AudioBuffer<float> normBuffer(processChannels, desiredBlockSize);
+            for (juce::int64 position = 0; position < normReader->lengthInSamples;)
+            {
+                const int numThisTime = static_cast<int>(juce::jmin<juce::int64>(desiredBlockSize,
+                                                                                 normReader->lengthInSamples - position));
+                normReader->read(&normBuffer, 0, numThisTime, position, true, true);
+                normBuffer.applyGain(0, numThisTime, gain);
+
+                if (!normWriter->writeFromAudioSampleBuffer(normBuffer, 0, numThisTime))
+                {
+                    error = u8str(u8"\u5199\u5165\u8f93\u51fa\u6587\u4ef6\u5931\u8d25");
+                    releaseChain(chain);
+                    return false;
+                }
+
+                position += numThisTime;
+            }
+
+            normReader.reset();
+            normWriter.reset();
+            if (!normTemp.overwriteTargetFileWithTemporary())
+            {
+                error = u8str(u8"\u65e0\u6cd5\u8986\u76d6\u5199\u5165\u8f93\u51fa\u6587\u4ef6");
+                releaseChain(chain);
+                return false;
+            }
+
+            finalized = true;
+        }
+
+        if (!finalized && !tempFile.overwriteTargetFileWithTemporary())
+        {
+            error = u8str(u8"\u65e0\u6cd5\u8986\u76d6\u5199\u5165\u8f93\u51fa\u6587\u4ef6");
+            releaseChain(chain);
+            return false;
+        }
+
+        releaseChain(chain);
+
+        if (stats != nullptr)
+        {
+            stats->readTiming = readTiming;
+            stats->processTiming = processTiming;
+            stats->writeTiming = writeTiming;
+            stats->outputPeak = outputPeak;
+            stats->clippedSamples = clippedSamples;
+        }
+
+        if (stats != nullptr && totalSamples > 0)
+        {
+            const double dryRms = std::sqrt(drySumSquares / static_cast<double>(totalSamples));
+            const double diffRms = std::sqrt(diffSumSquares / static_cast<double>(totalSamples));
+            stats->inputRmsDb = juce::Decibels::gainToDecibels(dryRms, -300.0);
+            stats->diffRmsDb = juce::Decibels::gainToDecibels(diffRms, -300.0);
+            stats->maxAbsDiff = maxAbsDiff;
+        }
+        return true;
+    }
+
+    std::vector<float> processInterleavedFloatArray(const float* inputInterleaved,
+                                                    int numChannels,
+                                                    int numSamples,
+                                                    double sampleRate,
+                                                    juce::String& error)
+    {
+        std::vector<float> output(static_cast<size_t>(numSamples), 0.0f);
+        processInterleavedFloatArray(inputInterleaved, numChannels, numSamples, sampleRate,
+                                     output.data(), error);
+        return output;
+    }
+
+    // Alloc-free variant: writes the mono result into a caller-provided
+    // buffer of numSamples floats and reuses the session scratch buffer,
+    // which only ever grows. Drivers hammering this with thousands of short
+    // drum hits per minute stop paying an allocation and page-fault tax on
+    // every call.
+    bool processInterleavedFloatArray(const float* inputInterleaved,
+                                      int numChannels,
+                                      int numSamples,
+                                      double sampleRate,
+                                      float* outputMono,
+                                      juce::String& error)
+    {
+        const auto chain = host.getChain();
+        if (chain.empty())
+        {
+            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
+            return false;
+        }
+
+        if (inputInterleaved == nullptr || outputMono == nullptr
+            || numChannels <= 0 || numSamples <= 0 || sampleRate <= 0.0)
+        {
+            error = u8str(u8"\u6570\u7ec4\u8f93\u5165\u53c2\u6570\u65e0\u6548");
+            return false;
+        }
+
+        const int desiredBlockSize = juce::jlimit(64, 8192, lastBlockSize);
+        const auto layout = getChainChannelLayout(chain, numChannels);
+        const int processChannels = layout.processChannels;
+
+        ensureSessionPrepared(chain, processChannels, sampleRate, desiredBlockSize);
+        for (auto* plugin : chain)
+            plugin->reset();
+
+        // avoidReallocating: the scratch arena grows to the largest
+        // configuration seen and is reused verbatim afterwards.
+        sessionBuffer.setSize(layout.bufferChannels, desiredBlockSize, false, false, true);
+
+        int position = 0;
+        while (position < numSamples)
+        {
+            const int numThisTime = juce::jmin(desiredBlockSize, numSamples - position);
+
+            processInterleavedBlock(chain, sessionBuffer,
+                                    inputInterleaved + static_cast<size_t>(position) * static_cast<size_t>(numChannels),
+                                    numChannels, processChannels, numThisTime,
+                                    outputMono + position);
+
+            position += numThisTime;
+        }
+
+        return true;
+    }
+
+    // Splits one long input across several plugin instances: each worker
+    // renders its segment plus a user-controlled overlap region before it,
+    // which both settles plugin state and provides the material for a linear
+    // crossfade at the seam. Segments go to float32 temp files, so the merge
+    // pass adds no quantization. Intended for stateless-ish or short-tail
+    // effects; long-tail reverbs should stay on the serial path.
+    static bool renderFileChunkedParallel(PluginHost& host,
+                                          int blockSize,
+                                          const juce::File& inputFile,
+                                          const juce::File& outputWavFile,
+                                          int numWorkers,
+                                          double overlapSeconds,
+                                          juce::String& error,
+                                          int bitDepth = 24)
+    {
+        if (!isSupportedBitDepth(bitDepth))
+        {
+            error = u8str(u8"\u4e0d\u652f\u6301\u7684\u8f93\u51fa\u4f4d\u6df1\u5ea6\uff08\u4ec5\u652f\u6301 16/24/32\uff09");
+            return false;
+        }
+
+        auto* primary = host.get();
+        if (primary == nullptr)
+        {
+            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
+            return false;
+        }
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(inputFile));
+        if (reader == nullptr)
+        {
+            error = u8str(u8"\u65e0\u6cd5\u8bfb\u53d6\u8f93\u5165\u97f3\u9891\u6587\u4ef6");
+            return false;
+        }
+
+        const auto sampleRate = reader->sampleRate;
+        const auto totalFrames = reader->lengthInSamples;
+        const auto overlapFrames = static_cast<juce::int64>(juce::jmax(0.0, overlapSeconds) * sampleRate);
+
+        const int workers = juce::jlimit(1, juce::SystemStats::getNumCpus(), numWorkers);
+        const auto segmentFrames = (totalFrames + workers - 1) / juce::jmax(1, workers);
+
+        // Not worth splitting (or the overlap would dominate): serial path.
+        if (workers < 2 || segmentFrames <= overlapFrames * 2)
+            return renderFile(*primary, blockSize, inputFile, outputWavFile, error, nullptr, {}, bitDepth);
+
+        reader.reset();
+
+        std::vector<std::unique_ptr<juce::AudioPluginInstance>> instances;
+        for (int i = 0; i < workers; ++i)
+        {
+            auto instance = host.acquireInstance(sampleRate, blockSize, error);
+            if (instance == nullptr)
+            {
+                for (auto& acquired : instances)
+                    host.releaseInstance(std::move(acquired));
+                return false;
+            }
+            instances.push_back(std::move(instance));
+        }
+
+        std::vector<ChunkSegment> segments(static_cast<size_t>(workers));
+        for (int i = 0; i < workers; ++i)
+        {
+            auto& segment = segments[static_cast<size_t>(i)];
+            segment.start = juce::jmin(totalFrames, segmentFrames * i);
+            segment.end = juce::jmin(totalFrames, segmentFrames * (i + 1));
+            segment.renderStart = i == 0 ? 0 : segment.start - overlapFrames;
+            segment.tempFile = juce::File::createTempFile("vsthost_segment.wav");
+        }
+
+        {
+            juce::ThreadPool pool(workers);
+            for (int i = 0; i < workers; ++i)
+            {
+                auto* plugin = instances[static_cast<size_t>(i)].get();
+                auto* segment = &segments[static_cast<size_t>(i)];
+                pool.addJob([plugin, segment, &inputFile, blockSize]
+                {
+                    segment->ok = renderSegmentToTemp(*plugin, inputFile, blockSize,
+                                                      segment->renderStart, segment->end,
+                                                      segment->tempFile, segment->error);
+                });
+            }
+
+            while (pool.getNumJobs() > 0)
+                juce::Thread::sleep(10);
+        }
+
+        auto cleanupTemps = [&segments]
+        {
+            for (auto& segment : segments)
+                segment.tempFile.deleteFile();
+        };
+
+        for (const auto& segment : segments)
+        {
+            if (!segment.ok)
+            {
+                error = segment.error;
+                cleanupTemps();
+                return false;
+            }
+        }
+
+        const bool merged = mergeSegmentsWithCrossfade(segments, overlapFrames, sampleRate, outputWavFile, bitDepth, error);
+        cleanupTemps();
+
+        for (auto& instance : instances)
+            host.releaseInstance(std::move(instance));
+
+        return merged;
+    }
+
+    // One static parameter assignment of a variant, normalized 0..1.
+    struct ParameterSetting
+    {
+        int parameterIndex = 0;
+        float value = 0.0f;
+    };
+
+    struct Variant
+    {
+        std::vector<ParameterSetting> settings;
+        juce::File output;
+    };
+
+    // Renders K parameter settings of one input in a single session: each
+    // block is decoded once and fanned out to one prepared clone per
+    // variant, so an A/B sweep pays the read side once instead of K times.
+    // Clones come from (and return to) the warm instance pool.
+    bool renderVariants(const juce::File& inputFile,
+                        const std::vector<Variant>& variants,
+                        juce::String& error)
+    {
+        if (host.get() == nullptr)
+        {
+            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
+            return false;
+        }
+
+        if (variants.empty())
+        {
+            error = u8str(u8"\u6279\u91cf\u4efb\u52a1\u4e3a\u7a7a");
+            return false;
+        }
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        auto reader = createBestReaderFor(formatManager, inputFile);
+        if (reader == nullptr)
+        {
+            error = u8str(u8"\u65e0\u6cd5\u8bfb\u53d6\u8f93\u5165\u97f3\u9891\u6587\u4ef6");
+            return false;
+        }
+
+        const auto sampleRate = reader->sampleRate;
+        const auto numSamples64 = reader->lengthInSamples;
+        const int numInputChannels = static_cast<int>(reader->numChannels);
+        const int desiredBlockSize = juce::jlimit(64, 8192, lastBlockSize);
+
+        struct VariantState
+        {
+            std::unique_ptr<juce::AudioPluginInstance> instance;
+            std::unique_ptr<juce::TemporaryFile> tempFile;
+            std::unique_ptr<juce::AudioFormatWriter> writer;
+        };
+
+        std::vector<VariantState> states(variants.size());
+
+        auto releaseAll = [&]
+        {
+            for (auto& state : states)
+            {
+                state.writer.reset();
+                if (state.instance != nullptr)
+                {
+                    state.instance->releaseResources();
+                    state.instance->setNonRealtime(false);
+                    host.releaseInstance(std::move(state.instance));
+                }
+            }
+        };
+
+        int processChannels = numInputChannels;
+
+        for (size_t i = 0; i < variants.size(); ++i)
+        {
+            auto& state = states[i];
+
+            state.instance = host.acquireInstance(sampleRate, desiredBlockSize, error);
+            if (state.instance == nullptr)
+            {
+                releaseAll();
+                return false;
+            }
+
+            auto& plugin = *state.instance;
+            if (numInputChannels == 1 && plugin.getTotalNumOutputChannels() >= 2)
+                processChannels = 2;
+
+            plugin.setNonRealtime(true);
+            plugin.setPlayConfigDetails(processChannels, processChannels, sampleRate, desiredBlockSize);
+            plugin.prepareToPlay(sampleRate, desiredBlockSize);
+            plugin.reset();
+            plugin.suspendProcessing(false);
+
+            const auto& parameters = plugin.getParameters();
+            for (const auto& setting : variants[i].settings)
+                if (juce::isPositiveAndBelow(setting.parameterIndex, parameters.size()))
+                    parameters[setting.parameterIndex]->setValue(juce::jlimit(0.0f, 1.0f, setting.value));
+
+            variants[i].output.getParentDirectory().createDirectory();
+            state.tempFile = std::make_unique<juce::TemporaryFile>(variants[i].output);
+
+            std::unique_ptr<juce::FileOutputStream> outputStream(state.tempFile->getFile().createOutputStream());
+            if (outputStream == nullptr || !outputStream->openedOk())
+            {
+                error = u8str(u8"\u65e0\u6cd5\u521b\u5efa\u8f93\u51fa\u6587\u4ef6\u6d41");
+                releaseAll();
+                return false;
+            }
+
+            state.writer = createWriterForOutput(variants[i].output, std::move(outputStream),
+                                                 sampleRate, processChannels, outputBitDepth);
+            if (state.writer == nullptr)
+            {
+                error = u8str(u8"\u65e0\u6cd5\u521b\u5efa\u97f3\u9891\u5199\u5165\u5668");
+                releaseAll();
+                return false;
+            }
+        }
+
+        // Like the other render paths, the processBlock buffer covers the
+        // plugin's own channel counts, not just the file's.
+        int bufferChannels = juce::jmax(processChannels, numInputChannels);
+        for (auto& state : states)
+            bufferChannels = juce::jmax(bufferChannels,
+                                        juce::jmax(state.instance->getTotalNumInputChannels(),
+                                                   state.instance->getTotalNumOutputChannels()));
+
+        juce::AudioBuffer<float> decoded(juce::jmax(processChannels, numInputChannels), desiredBlockSize);
+        juce::AudioBuffer<float> scratch(bufferChannels, desiredBlockSize);
+        juce::MidiBuffer midi;
+
+        bool writeOk = true;
+        for (juce::int64 position = 0; position < numSamples64 && writeOk;)
+        {
+            const int numThisTime = static_cast<int>(juce::jmin<juce::int64>(desiredBlockSize, numSamples64 - position));
+
+            decoded.clear();
+            reader->read(&decoded, 0, numThisTime, position, true, true);
+
+            if (numInputChannels == 1 && processChannels == 2)
+                decoded.copyFrom(1, 0, decoded, 0, 0, numThisTime);
+
+            for (auto& state : states)
+            {
+                scratch.clear();
+                for (int ch = 0; ch < processChannels; ++ch)
+                    scratch.copyFrom(ch, 0, decoded, ch, 0, numThisTime);
+
+                juce::AudioBuffer<float> view(scratch.getArrayOfWritePointers(), bufferChannels, numThisTime);
+                state.instance->processBlock(view, midi);
+
+                if (!state.writer->writeFromAudioSampleBuffer(scratch, 0, numThisTime))
+                {
+                    writeOk = false;
+                    break;
+                }
+            }
+
+            position += numThisTime;
+        }
+
+        for (auto& state : states)
+            state.writer.reset();
+
+        if (!writeOk)
+        {
+            error = u8str(u8"\u5199\u5165\u8f93\u51fa\u6587\u4ef6\u5931\u8d25");
+            releaseAll();
+            return false;
+        }
+
+        for (auto& state : states)
+        {
+            if (!state.tempFile->overwriteTargetFileWithTemporary())
+            {
+                error = u8str(u8"\u65e0\u6cd5\u8986\u76d6\u5199\u5165\u8f93\u51fa\u6587\u4ef6");
+                releaseAll();
+                return false;
+            }
+        }
+
+        releaseAll();
+        return true;
+    }
+
+    // MIDI-driven render for instrument plugins - the opposite of effect
+    // processing: fire notes at a sampler and capture what it plays. Events
+    // are scheduled into the per-block MidiBuffer with sample-accurate
+    // offsets and the output is recorded until the last event plus the
+    // requested tail, so a kit's velocity layers render in one prepared
+    // session instead of one DAW export each.
+    struct MidiNote
+    {
+        int noteNumber = 60;
+        int velocity = 100; // 1-127
+        double startSeconds = 0.0;
+        double lengthSeconds = 0.25;
+    };
+
+    bool renderMidiFileToFile(const juce::File& midiFile,
+                              const juce::File& outputWavFile,
+                              double sampleRate,
+                              double tailSeconds,
+                              juce::String& error)
+    {
+        juce::FileInputStream stream(midiFile);
+        juce::MidiFile midi;
+        if (!stream.openedOk() || !midi.readFrom(stream))
+        {
+            error = u8str(u8"\u65e0\u6cd5\u8bfb\u53d6 MIDI \u6587\u4ef6");
+            return false;
+        }
+
+        midi.convertTimestampTicksToSeconds();
+
+        juce::MidiMessageSequence sequence;
+        for (int track = 0; track < midi.getNumTracks(); ++track)
+            sequence.addSequence(*midi.getTrack(track), 0.0);
+        sequence.updateMatchedPairs();
+
+        return renderMidiSequenceToFile(sequence, outputWavFile, sampleRate, tailSeconds, error);
+    }
+
+    bool renderNotesToFile(const std::vector<MidiNote>& notes,
+                           const juce::File& outputWavFile,
+                           double sampleRate,
+                           double tailSeconds,
+                           juce::String& error)
+    {
+        juce::MidiMessageSequence sequence;
+        for (const auto& note : notes)
+        {
+            const auto velocity = static_cast<juce::uint8>(juce::jlimit(1, 127, note.velocity));
+            sequence.addEvent(juce::MidiMessage::noteOn(1, note.noteNumber, velocity), note.startSeconds);
+            sequence.addEvent(juce::MidiMessage::noteOff(1, note.noteNumber),
+                              note.startSeconds + juce::jmax(0.01, note.lengthSeconds));
+        }
+        sequence.updateMatchedPairs();
+
+        return renderMidiSequenceToFile(sequence, outputWavFile, sampleRate, tailSeconds, error);
+    }
+
+    bool renderMidiSequenceToFile(const juce::MidiMessageSequence& sequence,
+                                  const juce::File& outputWavFile,
+                                  double sampleRate,
+                                  double tailSeconds,
+                                  juce::String& error)
+    {
+        const auto chain = host.getChain();
+        if (chain.empty())
+        {
+            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
+            return false;
+        }
+
+        if (sequence.getNumEvents() == 0)
+        {
+            error = u8str(u8"MIDI \u4e2d\u6ca1\u6709\u4e8b\u4ef6");
+            return false;
+        }
+
+        if (sampleRate <= 0.0)
+        {
+            error = u8str(u8"\u6570\u7ec4\u8f93\u5165\u53c2\u6570\u65e0\u6548");
+            return false;
+        }
+
+        endArraySession();
+
+        const int desiredBlockSize = juce::jlimit(64, 8192, lastBlockSize);
+
+        int numPluginOuts = 1;
+        for (auto* plugin : chain)
+            numPluginOuts = juce::jmax(numPluginOuts, plugin->getTotalNumOutputChannels());
+
+        const int processChannels = juce::jmin(2, numPluginOuts);
+
+        for (auto* plugin : chain)
+        {
+            plugin->setNonRealtime(true);
+            plugin->setPlayConfigDetails(processChannels, processChannels, sampleRate, desiredBlockSize);
+            plugin->prepareToPlay(sampleRate, desiredBlockSize);
+            plugin->reset();
+            plugin->suspendProcessing(false);
+        }
+
+        outputWavFile.getParentDirectory().createDirectory();
+        juce::TemporaryFile tempFile(outputWavFile);
+
+        std::unique_ptr<juce::FileOutputStream> outputStream(tempFile.getFile().createOutputStream());
+        if (outputStream == nullptr || !outputStream->openedOk())
+        {
+            error = u8str(u8"\u65e0\u6cd5\u521b\u5efa\u8f93\u51fa\u6587\u4ef6\u6d41");
+            releaseChain(chain);
+            return false;
+        }
+
+        auto writer = createWriterForOutput(outputWavFile, std::move(outputStream),
+                                            sampleRate, processChannels, outputBitDepth);
+        if (writer == nullptr)
+        {
+            error = u8str(u8"\u65e0\u6cd5\u521b\u5efa\u97f3\u9891\u5199\u5165\u5668");
+            releaseChain(chain);
+            return false;
+        }
+
+        const double endSeconds = sequence.getEndTime() + juce::jmax(0.0, tailSeconds);
+        const auto totalFrames = static_cast<juce::int64>(std::ceil(endSeconds * sampleRate));
+
+        juce::AudioBuffer<float> buffer(processChannels, desiredBlockSize);
+        juce::MidiBuffer midiBlock;
+        int eventIndex = 0;
+
+        bool writeOk = true;
+        for (juce::int64 position = 0; position < totalFrames && writeOk;)
+        {
+            const int numThisTime = static_cast<int>(juce::jmin<juce::int64>(desiredBlockSize, totalFrames - position));
+
+            buffer.clear();
+            midiBlock.clear();
+
+            const double blockStart = static_cast<double>(position) / sampleRate;
+            const double blockEnd = static_cast<double>(position + numThisTime) / sampleRate;
+
+            while (eventIndex < sequence.getNumEvents())
+            {
+                const auto* event = sequence.getEventPointer(eventIndex);
+                const double timeStamp = event->message.getTimeStamp();
+                if (timeStamp >= blockEnd)
+                    break;
+
+                const int offset = juce::jlimit(0, numThisTime - 1,
+                                                static_cast<int>(std::floor((timeStamp - blockStart) * sampleRate)));
+                midiBlock.addEvent(event->message, offset);
+                ++eventIndex;
+            }
+
+            juce::AudioBuffer<float> view(buffer.getArrayOfWritePointers(), processChannels, numThisTime);
+            for (auto* plugin : chain)
+                plugin->processBlock(view, midiBlock);
+
+            writeOk = writer->writeFromAudioSampleBuffer(buffer, 0, numThisTime);
+            position += numThisTime;
+        }
+
+        writer.reset();
+        releaseChain(chain);
+
+        if (!writeOk)
+        {
+            error = u8str(u8"\u5199\u5165\u8f93\u51fa\u6587\u4ef6\u5931\u8d25");
+            return false;
+        }
+
+        if (!tempFile.overwriteTargetFileWithTemporary())
+        {
+            error = u8str(u8"\u65e0\u6cd5\u8986\u76d6\u5199\u5165\u8f93\u51fa\u6587\u4ef6");
+            return false;
+        }
+
+        return true;
+    }
+
+    // Streaming variant of the array path. Plugin state (reverb tails,
+    // compressor envelopes) carries across pushed chunks, and memory stays
+    // bounded to one block regardless of total input length.
+    bool beginStream(double sampleRate, int numChannels, juce::String& error)
+    {
+        const auto chain = host.getChain();
+        if (chain.empty())
+        {
+            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
+            return false;
+        }
+
+        if (numChannels <= 0 || sampleRate <= 0.0)
+        {
+            error = u8str(u8"\u6570\u7ec4\u8f93\u5165\u53c2\u6570\u65e0\u6548");
+            return false;
+        }
+
+        const int desiredBlockSize = juce::jlimit(64, 8192, lastBlockSize);
+        const auto layout = getChainChannelLayout(chain, numChannels);
+
+        ensureSessionPrepared(chain, layout.processChannels, sampleRate, desiredBlockSize);
+        for (auto* plugin : chain)
+            plugin->reset();
+
+        streamBuffer.setSize(layout.bufferChannels, desiredBlockSize);
+        streamChannels = numChannels;
+        streaming = true;
+        return true;
+    }
+
+    bool pushStreamBlock(const float* inputInterleaved, int numSamples, std::vector<float>& output, juce::String& error)
+    {
+        if (!streaming || sessionChain.empty())
+        {
+            error = u8str(u8"\u6d41\u5f0f\u4f1a\u8bdd\u672a\u5f00\u59cb");
+            return false;
+        }
+
+        if (inputInterleaved == nullptr || numSamples <= 0)
+        {
+            error = u8str(u8"\u6570\u7ec4\u8f93\u5165\u53c2\u6570\u65e0\u6548");
+            return false;
+        }
+
+        output.resize(static_cast<size_t>(numSamples));
+
+        int position = 0;
+        while (position < numSamples)
+        {
+            const int numThisTime = juce::jmin(sessionBlockSize, numSamples - position);
+
+            processInterleavedBlock(sessionChain, streamBuffer,
+                                    inputInterleaved + static_cast<size_t>(position) * static_cast<size_t>(streamChannels),
+                                    streamChannels, sessionChannels, numThisTime,
+                                    output.data() + position);
+
+            position += numThisTime;
+        }
+
+        return true;
+    }
+
+    // Ends the stream; the session stays prepared so the next stream (or
+    // array call) with the same configuration starts instantly.
+    void endStream()
+    {
+        streaming = false;
+    }
+
+    std::vector<float> processMonoFloatArray(const float* inputMono, int numSamples, double sampleRate, juce::String& error)
+    {
+        return processInterleavedFloatArray(inputMono, 1, numSamples, sampleRate, error);
+    }
+
+    std::vector<float> processMonoFloatArray(const float* inputMono, int numSamples, juce::String& error)
+    {
+        return processMonoFloatArray(inputMono, numSamples, 44100.0, error);
+    }
+
+    void setBlockSize(int newBlockSize) { lastBlockSize = newBlockSize; }
+
+    // 16/24 write integer WAV; 32 writes float32 (no packing, and chained
+    // tools re-reading the result get the processed samples bit-exact).
+    bool setOutputBitDepth(int bitDepth, juce::String& error)
+    {
+        if (!isSupportedBitDepth(bitDepth))
+        {
+            error = u8str(u8"\u4e0d\u652f\u6301\u7684\u8f93\u51fa\u4f4d\u6df1\u5ea6\uff08\u4ec5\u652f\u6301 16/24/32\uff09");
+            return false;
+        }
+
+        outputBitDepth = bitDepth;
+        return true;
+    }
+
+    int getOutputBitDepth() const { return outputBitDepth; }
+
+    // 0 keeps the input file's rate; anything else resamples on the fly
+    // inside the render, so a mixed 44.1k/48k library runs through the
+    // plugins at one rate in a single pass instead of a separate conversion
+    // pass over every file first.
+    bool setTargetSampleRate(double rate, juce::String& error)
+    {
+        if (rate != 0.0 && rate < 8000.0)
+        {
+            error = u8str(u8"\u4e0d\u652f\u6301\u7684\u76ee\u6807\u91c7\u6837\u7387\uff08\u6700\u4f4e 8000\uff09");
+            return false;
+        }
+
+        targetSampleRate = rate;
+        return true;
+    }
+
+    double getTargetSampleRate() const { return targetSampleRate; }
+
+    // Disabling stats skips the dry-buffer capture and the per-block
+    // dry/wet comparison entirely - for fast plugins that copy is a large
+    // share of the loop and doubles cache pressure at big block sizes.
+    void setStatsEnabled(bool shouldComputeStats) { statsEnabled = shouldComputeStats; }
+    bool isStatsEnabled() const { return statsEnabled; }
+
+    // Scales the rendered file so its peak hits full scale, using the peak
+    // already measured during the render - no separate find-peak pass.
+    void setNormalizeEnabled(bool shouldNormalize) { normalizeEnabled = shouldNormalize; }
+    bool isNormalizeEnabled() const { return normalizeEnabled; }
+
+    static bool isSupportedBitDepth(int bitDepth)
+    {
+        return bitDepth == 16 || bitDepth == 24 || bitDepth == 32;
+    }
+
+    // Releases the plugin kept hot by the array session. Safe to call when no
+    // session is active.
+    void endArraySession()
+    {
+        if (!sessionChain.empty() && sessionChain == host.getChain())
+            releaseChain(sessionChain);
+
+        sessionChain.clear();
+        streaming = false;
+    }
+
+private:
+    // Prefers a memory-mapped reader (WAV/AIFF) so block reads come straight
+    // out of the OS page cache with no buffered-stream copies - rendering the
+    // same multi-gigabyte export through several settings re-touches the same
+    // pages instead of re-reading the file. Falls back to the streaming
+    // reader for formats that can't map (FLAC, MP3).
+    static std::unique_ptr<juce::AudioFormatReader> createBestReaderFor(juce::AudioFormatManager& formatManager,
+                                                                        const juce::File& file)
+    {
+        if (auto* format = formatManager.findFormatForFileExtension(file.getFileExtension()))
+        {
+            if (auto mapped = std::unique_ptr<juce::MemoryMappedAudioFormatReader>(format->createMemoryMappedReader(file)))
+                if (mapped->mapEntireFile())
+                    return mapped;
+        }
+
+        return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(file));
+    }
+
+    // Picks the output codec from the file extension: .flac uses JUCE's
+    // FLAC encoder (bit depth clamped to its 24-bit maximum), everything
+    // else writes WAV. In the file pipeline the encode runs on the writer
+    // thread either way, so FLAC's CPU cost overlaps processBlock instead
+    // of serializing after the render - archival stems go out compressed in
+    // the same single pass.
+    static std::unique_ptr<juce::AudioFormatWriter> createWriterForOutput(const juce::File& outputFile,
+                                                                          std::unique_ptr<juce::FileOutputStream> stream,
+                                                                          double sampleRate,
+                                                                          int numChannels,
+                                                                          int bitDepth)
+    {
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+
+        if (outputFile.hasFileExtension("flac"))
+        {
+            juce::FlacAudioFormat flac;
+            writer.reset(flac.createWriterFor(stream.get(), sampleRate,
+                                              static_cast<unsigned int>(numChannels),
+                                              juce::jmin(bitDepth, 24), {}, 0));
+        }
+        else
+        {
+            juce::WavAudioFormat wav;
+            writer.reset(wav.createWriterFor(stream.get(), sampleRate,
+                                             static_cast<unsigned int>(numChannels),
+                                             static_cast<unsigned int>(bitDepth), {}, 0));
+        }
+
+        if (writer != nullptr)
+            stream.release();
+
+        return writer;
+    }
+
+    static void releaseChain(const std::vector<juce::AudioPluginInstance*>& chain)
+    {
+        for (auto* plugin : chain)
+        {
+            plugin->releaseResources();
+            plugin->setNonRealtime(false);
+        }
+    }
+
+    struct ChunkSegment
+    {
+        juce::int64 start = 0;       // first frame of the segment proper
+        juce::int64 renderStart = 0; // includes the priming/crossfade overlap
+        juce::int64 end = 0;
+        juce::File tempFile;
+        bool ok = false;
+        juce::String error;
+    };
+
+    // Renders [startFrame, endFrame) of the input through one instance into a
+    // float32 WAV. Serial loop: each worker already owns a whole core.
+    static bool renderSegmentToTemp(juce::AudioPluginInstance& plugin,
+                                    const juce::File& inputFile,
+                                    int blockSize,
+                                    juce::int64 startFrame,
+                                    juce::int64 endFrame,
+                                    const juce::File& tempFile,
+                                    juce::String& error)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        auto reader = createBestReaderFor(formatManager, inputFile);
+        if (reader == nullptr)
+        {
+            error = u8str(u8"\u65e0\u6cd5\u8bfb\u53d6\u8f93\u5165\u97f3\u9891\u6587\u4ef6");
+            return false;
+        }
+
+        const auto sampleRate = reader->sampleRate;
+        const int numInputChannels = static_cast<int>(reader->numChannels);
+        const int desiredBlockSize = juce::jlimit(64, 8192, blockSize);
+
+        const int numPluginIns = juce::jmax(1, plugin.getTotalNumInputChannels());
+        const int numPluginOuts = juce::jmax(1, plugin.getTotalNumOutputChannels());
+
+        int processChannels = numInputChannels;
+        if (numInputChannels == 1 && numPluginOuts >= 2)
+            processChannels = 2;
+
+        plugin.setNonRealtime(true);
+        plugin.setPlayConfigDetails(processChannels, processChannels, sampleRate, desiredBlockSize);
+        plugin.prepareToPlay(sampleRate, desiredBlockSize);
+        plugin.reset();
+        plugin.suspendProcessing(false);
+
+        const int bufferChannels = juce::jmax(processChannels, juce::jmax(numPluginIns, numPluginOuts));
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::FileOutputStream> outputStream(tempFile.createOutputStream());
+        if (outputStream == nullptr || !outputStream->openedOk())
+        {
+            error = u8str(u8"\u65e0\u6cd5\u521b\u5efa\u8f93\u51fa\u6587\u4ef6\u6d41");
+            plugin.releaseResources();
+            return false;
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(outputStream.get(),
+                                                                            sampleRate,
+                                                                            static_cast<unsigned int>(processChannels),
+                                                                            32,
+                                                                            {},
+                                                                            0));
+        if (writer == nullptr)
+        {
+            error = u8str(u8"\u65e0\u6cd5\u521b\u5efa WAV \u5199\u5165\u5668");
+            plugin.releaseResources();
+            return false;
+        }
+        outputStream.release();
+
+        juce::AudioBuffer<float> buffer(bufferChannels, desiredBlockSize);
+        juce::MidiBuffer midi;
+
+        bool writeOk = true;
+        for (juce::int64 position = startFrame; position < endFrame && writeOk;)
+        {
+            const int numThisTime = static_cast<int>(juce::jmin<juce::int64>(desiredBlockSize, endFrame - position));
+
+            buffer.clear();
+            reader->read(&buffer, 0, numThisTime, position, true, true);
+
+            if (numInputChannels == 1 && processChannels == 2)
+                buffer.copyFrom(1, 0, buffer, 0, 0, numThisTime);
+
+            plugin.processBlock(buffer, midi);
+
+            writeOk = writer->writeFromAudioSampleBuffer(buffer, 0, numThisTime);
+            position += numThisTime;
+        }
+
+        writer.reset();
+        plugin.releaseResources();
+        plugin.setNonRealtime(false);
+
+        if (!writeOk)
+            error = u8str(u8"\u5199\u5165\u8f93\u51fa\u6587\u4ef6\u5931\u8d25");
+
+        return writeOk;
+    }
+
+    // Stitches the rendered segments into the final output at the requested
+    // bit depth, linearly crossfading each seam over the overlap window that
+    // both neighbours rendered.
+    static bool mergeSegmentsWithCrossfade(const std::vector<ChunkSegment>& segments,
+                                           juce::int64 overlapFrames,
+                                           double sampleRate,
+                                           const juce::File& outputWavFile,
+                                           int bitDepth,
+                                           juce::String& error)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        outputWavFile.getParentDirectory().createDirectory();
+        juce::TemporaryFile tempFile(outputWavFile);
+
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        juce::AudioBuffer<float> block;
+        juce::AudioBuffer<float> fadeA, fadeB;
+
+        for (size_t i = 0; i < segments.size(); ++i)
+        {
+            const auto& segment = segments[i];
+
+            auto segmentReader = createBestReaderFor(formatManager, segment.tempFile);
+            if (segmentReader == nullptr)
+            {
+                error = u8str(u8"\u65e0\u6cd5\u8bfb\u53d6\u5206\u6bb5\u4e34\u65f6\u6587\u4ef6");
+                return false;
+            }
+
+            const int channels = static_cast<int>(segmentReader->numChannels);
+
+            if (writer == nullptr)
+            {
+                std::unique_ptr<juce::FileOutputStream> outputStream(tempFile.getFile().createOutputStream());
+                if (outputStream == nullptr || !outputStream->openedOk())
+                {
+                    error = u8str(u8"\u65e0\u6cd5\u521b\u5efa\u8f93\u51fa\u6587\u4ef6\u6d41");
+                    return false;
+                }
+
+                writer = createWriterForOutput(outputWavFile, std::move(outputStream),
+                                               sampleRate, channels, bitDepth);
+                if (writer == nullptr)
+                {
+                    error = u8str(u8"\u65e0\u6cd5\u521b\u5efa\u97f3\u9891\u5199\u5165\u5668");
+                    return false;
+                }
+
+                block.setSize(channels, 8192);
+                fadeA.setSize(channels, static_cast<int>(juce::jmax<juce::int64>(1, overlapFrames)));
+                fadeB.setSize(channels, static_cast<int>(juce::jmax<juce::int64>(1, overlapFrames)));
+            }
+
+            const auto segmentLength = segmentReader->lengthInSamples;
+            juce::int64 localPosition = i == 0 ? 0 : overlapFrames;
+
+            if (i > 0 && overlapFrames > 0)
+            {
+                // Both neighbours rendered the overlap window: previous
+                // segment's tail fades out while this segment's primer fades in.
+                std::unique_ptr<juce::AudioFormatReader> previousReader(
+                    formatManager.createReaderFor(segments[i - 1].tempFile));
+                if (previousReader == nullptr)
+                {
+                    error = u8str(u8"\u65e0\u6cd5\u8bfb\u53d6\u5206\u6bb5\u4e34\u65f6\u6587\u4ef6");
+                    return false;
+                }
+
+                const int overlap = static_cast<int>(overlapFrames);
+                fadeA.clear();
+                fadeB.clear();
+                previousReader->read(&fadeA, 0, overlap, previousReader->lengthInSamples - overlapFrames, true, true);
+                segmentReader->read(&fadeB, 0, overlap, 0, true, true);
+
+                for (int ch = 0; ch < channels; ++ch)
+                {
+                    auto* a = fadeA.getWritePointer(ch);
+                    const auto* b = fadeB.getReadPointer(ch);
+                    for (int j = 0; j < overlap; ++j)
+                    {
+                        const float t = static_cast<float>(j) / static_cast<float>(overlap);
+                        a[j] = a[j] * (1.0f - t) + b[j] * t;
+                    }
+                }
+
+                if (!writer->writeFromAudioSampleBuffer(fadeA, 0, overlap))
+                {
+                    error = u8str(u8"\u5199\u5165\u8f93\u51fa\u6587\u4ef6\u5931\u8d25");
+                    return false;
+                }
+            }
+
+            // Verbatim region; the last `overlapFrames` are left to the next
+            // segment's crossfade (except for the final segment).
+            const auto verbatimEnd = i + 1 < segments.size() ? segmentLength - overlapFrames : segmentLength;
+            while (localPosition < verbatimEnd)
+            {
+                const int numThisTime = static_cast<int>(juce::jmin<juce::int64>(block.getNumSamples(), verbatimEnd - localPosition));
+                block.clear();
+                segmentReader->read(&block, 0, numThisTime, localPosition, true, true);
+
+                if (!writer->writeFromAudioSampleBuffer(block, 0, numThisTime))
+                {
+                    error = u8str(u8"\u5199\u5165\u8f93\u51fa\u6587\u4ef6\u5931\u8d25");
+                    return false;
+                }
+
+                localPosition += numThisTime;
+            }
+        }
+
+        writer.reset();
+        if (!tempFile.overwriteTargetFileWithTemporary())
+        {
+            error = u8str(u8"\u65e0\u6cd5\u8986\u76d6\u5199\u5165\u8f93\u51fa\u6587\u4ef6");
+            return false;
+        }
+
+        return true;
+    }
+
+    struct ChainChannelLayout
+    {
+        int processChannels = 0;
+        int bufferChannels = 0;
+    };
+
+    // Mono inputs are promoted to stereo when any plugin in the chain has a
+    // stereo (or wider) output; the shared buffer is sized for the widest
+    // plugin in the chain.
+    static ChainChannelLayout getChainChannelLayout(const std::vector<juce::AudioPluginInstance*>& chain, int numInputChannels)
+    {
+        int numPluginIns = 1;
+        int numPluginOuts = 1;
+        for (auto* plugin : chain)
+        {
+            numPluginIns = juce::jmax(numPluginIns, plugin->getTotalNumInputChannels());
+            numPluginOuts = juce::jmax(numPluginOuts, plugin->getTotalNumOutputChannels());
+        }
+
+        ChainChannelLayout layout;
+        layout.processChannels = (numInputChannels == 1 && numPluginOuts >= 2) ? 2 : numInputChannels;
+        layout.bufferChannels = juce::jmax(layout.processChannels, juce::jmax(numPluginIns, numPluginOuts));
+        return layout;
+    }
+
+    // Runs one deinterleaved chunk through the chain and mixes the result
+    // down to mono. A view of numThisTime samples is handed to processBlock so
+    // partial chunks do not advance plugin state with padding zeros.
+    static void processInterleavedBlock(const std::vector<juce::AudioPluginInstance*>& chain,
+                                        juce::AudioBuffer<float>& buffer,
+                                        const float* input,
+                                        int numChannels,
+                                        int processChannels,
+                                        int numThisTime,
+                                        float* outDst)
+    {
+        buffer.clear();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* dst = buffer.getWritePointer(ch);
+            const float* src = input + static_cast<size_t>(ch);
+            for (int i = 0; i < numThisTime; ++i)
+                dst[i] = src[static_cast<size_t>(i) * static_cast<size_t>(numChannels)];
+        }
+
+        if (numChannels == 1 && processChannels == 2)
+            buffer.copyFrom(1, 0, buffer, 0, 0, numThisTime);
+
+        juce::AudioBuffer<float> view(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numThisTime);
+        juce::MidiBuffer midi;
+        for (auto* plugin : chain)
+            plugin->processBlock(view, midi);
+
+        if (processChannels == 1)
+        {
+            const auto* src = buffer.getReadPointer(0);
+            for (int i = 0; i < numThisTime; ++i)
+                outDst[i] = src[i];
+        }
+        else
+        {
+            const float scale = 1.0f / static_cast<float>(processChannels);
+
+            const auto* src0 = buffer.getReadPointer(0);
+            for (int i = 0; i < numThisTime; ++i)
+                outDst[i] = src0[i];
+
+            for (int ch = 1; ch < processChannels; ++ch)
+            {
+                const auto* src = buffer.getReadPointer(ch);
+                for (int i = 0; i < numThisTime; ++i)
+                    outDst[i] += src[i];
+            }
+
+            for (int i = 0; i < numThisTime; ++i)
+                outDst[i] *= scale;
+        }
+    }
+
+    // prepareToPlay on big reverb/sampler plugins costs far more than
+    // rendering a short drum hit, so the array path keeps the plugin prepared
+    // and only re-prepares when the (plugin, channels, rate, blockSize) tuple
+    // changes.
+    void ensureSessionPrepared(const std::vector<juce::AudioPluginInstance*>& chain, int processChannels, double sampleRate, int blockSize)
+    {
+        if (chain == sessionChain
+            && processChannels == sessionChannels
+            && juce::approximatelyEqual(sampleRate, sessionSampleRate)
+            && blockSize == sessionBlockSize)
+            return;
+
+        endArraySession();
+
+        for (auto* plugin : chain)
+        {
+            plugin->setNonRealtime(true);
+            plugin->setPlayConfigDetails(processChannels, processChannels, sampleRate, blockSize);
+            plugin->prepareToPlay(sampleRate, blockSize);
+            plugin->suspendProcessing(false);
+        }
+
+        sessionChain = chain;
+        sessionChannels = processChannels;
+        sessionSampleRate = sampleRate;
+        sessionBlockSize = blockSize;
+    }
+
+    // Whole-block stats kernel for the render loop. The difference is formed
+    // with FloatVectorOperations and the squared sums use four independent
+    // accumulators so the compiler can keep them in vector registers.
+    static void accumulateBlockStats(const float* dry, const float* wet, float* diffScratch, int numSamples,
+                                     double& drySumSquares, double& diffSumSquares, float& maxAbsDiff)
+    {
+        juce::FloatVectorOperations::subtract(diffScratch, wet, dry, numSamples);
+
+        const auto diffRange = juce::FloatVectorOperations::findMinAndMax(diffScratch, numSamples);
+        maxAbsDiff = juce::jmax(maxAbsDiff, std::abs(diffRange.getStart()), std::abs(diffRange.getEnd()));
+
+        double dry0 = 0.0, dry1 = 0.0, dry2 = 0.0, dry3 = 0.0;
+        double diff0 = 0.0, diff1 = 0.0, diff2 = 0.0, diff3 = 0.0;
+
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            dry0 += static_cast<double>(dry[i + 0]) * static_cast<double>(dry[i + 0]);
+            dry1 += static_cast<double>(dry[i + 1]) * static_cast<double>(dry[i + 1]);
+            dry2 += static_cast<double>(dry[i + 2]) * static_cast<double>(dry[i + 2]);
+            dry3 += static_cast<double>(dry[i + 3]) * static_cast<double>(dry[i + 3]);
+
+            diff0 += static_cast<double>(diffScratch[i + 0]) * static_cast<double>(diffScratch[i + 0]);
+            diff1 += static_cast<double>(diffScratch[i + 1]) * static_cast<double>(diffScratch[i + 1]);
+            diff2 += static_cast<double>(diffScratch[i + 2]) * static_cast<double>(diffScratch[i + 2]);
+            diff3 += static_cast<double>(diffScratch[i + 3]) * static_cast<double>(diffScratch[i + 3]);
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            dry0 += static_cast<double>(dry[i]) * static_cast<double>(dry[i]);
+            diff0 += static_cast<double>(diffScratch[i]) * static_cast<double>(diffScratch[i]);
+        }
+
+        drySumSquares += dry0 + dry1 + dry2 + dry3;
+        diffSumSquares += diff0 + diff1 + diff2 + diff3;
+    }
+
+    struct BlockSlot
+    {
+        juce::AudioBuffer<float> buffer;
+        int numSamples = 0;
+    };
+
+    // Bounded FIFO of slot indices handed between the pipeline stages.
+    // pop() returns -1 once finish() has been called and the queue is drained.
+    class SlotQueue
+    {
+    public:
+        void push(int index)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(index);
+            }
+            condition.notify_one();
+        }
+
+        int pop()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return !queue.empty() || finished; });
+            if (queue.empty())
+                return -1;
+
+            const int index = queue.front();
+            queue.pop_front();
+            return index;
+        }
+
+        void finish()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished = true;
+            }
+            condition.notify_all();
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<int> queue;
+        bool finished = false;
+    };
+
+    PluginHost& host;
+    int lastBlockSize = 1024;
+    int outputBitDepth = 24;
+    double targetSampleRate = 0.0; // 0 = follow the input file
+    bool statsEnabled = true;
+    bool normalizeEnabled = false;
+    std::vector<AutomationPoint> automationPoints;
+
+    std::vector<juce::AudioPluginInstance*> sessionChain;
+    int sessionChannels = 0;
+    double sessionSampleRate = 0.0;
+    int sessionBlockSize = 0;
+    juce::AudioBuffer<float> sessionBuffer; // grow-only scratch for the array path
+
+    juce::AudioBuffer<float> streamBuffer;
+    int streamChannels = 0;
+    bool streaming = false;
+};
+} // namespace vsthost
@@ -1,362 +1,147 @@
-#include <juce_audio_formats/juce_audio_formats.h>
-#include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <juce_gui_extra/juce_gui_extra.h>
 #include <BinaryData.h>
 
+#include "HostCore.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstdio>
 #include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
 #include <optional>
-
-static juce::String u8str(const char* s)
-{
-    return juce::String::fromUTF8(s);
-}
+#include <set>
+#include <thread>
 
 namespace vsthost
 {
-class PluginHost
+// Renders a list of input/output pairs concurrently across a pool of
+// independent plugin instances. Instances are created up front on the calling
+// thread (VST3 instantiation is message-thread-only); workers pull jobs from a
+// shared index so a slow file never strands an idle core.
+class BatchRenderer
 {
 public:
-    PluginHost()
+    struct Job
     {
-        formatManager.addDefaultFormats();
-    }
+        juce::File input;
+        juce::File output;
+    };
 
-    bool loadPluginFromFile(const juce::File& pluginFile, double sampleRate, int blockSize, juce::String& error)
+    struct Result
     {
-        unloadPlugin();
-
-        juce::OwnedArray<juce::PluginDescription> types;
-        for (auto* format : formatManager.getFormats())
-        {
-            format->findAllTypesForFile(types, pluginFile.getFullPathName());
-            if (!types.isEmpty())
-                break;
-        }
-
-        if (types.isEmpty())
-        {
-            error = u8str(u8"\u6ca1\u6709\u8bc6\u522b\u5230\u53ef\u52a0\u8f7d\u7684\u63d2\u4ef6\u7c7b\u578b\uff08\u4ec5\u652f\u6301\u5df2\u542f\u7528\u7684\u683c\u5f0f\uff0c\u5982 VST3\uff09");
-            return false;
-        }
-
-        pluginDescription = *types.getFirst();
-
-        std::unique_ptr<juce::AudioPluginInstance> instance(
-            formatManager.createPluginInstance(pluginDescription, sampleRate, blockSize, error));
-
-        if (instance == nullptr)
-            return false;
-
-        pluginInstance = std::move(instance);
-        return true;
-    }
+        juce::File input;
+        juce::File output;
+        bool ok = false;
+        juce::String error;
+    };
 
-    void unloadPlugin()
+    BatchRenderer(PluginHost& hostToUse, int numWorkersToUse)
+        : host(hostToUse),
+          numWorkers(juce::jlimit(1, juce::SystemStats::getNumCpus(), numWorkersToUse))
     {
-        if (pluginInstance != nullptr)
-            pluginInstance->releaseResources();
-
-        pluginInstance.reset();
-        pluginDescription = {};
     }
 
-    juce::AudioPluginInstance* get() const { return pluginInstance.get(); }
-    const juce::PluginDescription& getDescription() const { return pluginDescription; }
-
-private:
-    juce::AudioPluginFormatManager formatManager;
-    juce::PluginDescription pluginDescription;
-    std::unique_ptr<juce::AudioPluginInstance> pluginInstance;
-};
-
-class OfflineProcessor
-{
-public:
-    explicit OfflineProcessor(PluginHost& hostToUse) : host(hostToUse) {}
-
-    struct ProcessStats
-    {
-        double inputRmsDb = 0.0;
-        double diffRmsDb = 0.0;
-        float maxAbsDiff = 0.0f;
-        int outputChannels = 0;
-    };
-
-    bool processAudioFileToFile(const juce::File& inputFile,
-                                const juce::File& outputWavFile,
-                                juce::String& error,
-                                ProcessStats* stats = nullptr)
+    bool renderAll(const std::vector<Job>& jobs, int blockSize, std::vector<Result>& results, juce::String& error)
     {
-        auto* plugin = host.get();
-        if (plugin == nullptr)
-        {
-            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
-            return false;
-        }
-
-        juce::AudioFormatManager formatManager;
-        formatManager.registerBasicFormats();
-
-        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(inputFile));
-        if (reader == nullptr)
-        {
-            error = u8str(u8"\u65e0\u6cd5\u8bfb\u53d6\u8f93\u5165\u97f3\u9891\u6587\u4ef6");
-            return false;
-        }
-
-        const auto sampleRate = reader->sampleRate;
-        const auto numSamples64 = reader->lengthInSamples;
-        const int numInputChannels = static_cast<int>(reader->numChannels);
-
-        const int desiredBlockSize = juce::jlimit(64, 8192, lastBlockSize);
-
-        const int numPluginIns = juce::jmax(1, plugin->getTotalNumInputChannels());
-        const int numPluginOuts = juce::jmax(1, plugin->getTotalNumOutputChannels());
-
-        int processChannels = numInputChannels;
-
-        if (numInputChannels == 1 && numPluginOuts >= 2)
-            processChannels = 2;
+        results.clear();
 
-        if (stats != nullptr)
-            stats->outputChannels = processChannels;
-
-        plugin->setNonRealtime(true);
-        plugin->setPlayConfigDetails(processChannels, processChannels, sampleRate, desiredBlockSize);
-        plugin->prepareToPlay(sampleRate, desiredBlockSize);
-        plugin->reset();
-        plugin->suspendProcessing(false);
-
-        const int bufferChannels = juce::jmax(processChannels, juce::jmax(numPluginIns, numPluginOuts));
-
-        juce::WavAudioFormat wav;
-        outputWavFile.getParentDirectory().createDirectory();
-        juce::TemporaryFile tempFile(outputWavFile);
-
-        std::unique_ptr<juce::FileOutputStream> outputStream(tempFile.getFile().createOutputStream());
-        if (outputStream == nullptr || !outputStream->openedOk())
-        {
-            error = u8str(u8"\u65e0\u6cd5\u521b\u5efa\u8f93\u51fa\u6587\u4ef6\u6d41");
-            plugin->releaseResources();
-            return false;
-        }
-
-        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(outputStream.get(),
-                                                                            sampleRate,
-                                                                            static_cast<unsigned int>(processChannels),
-                                                                            24,
-                                                                            {},
-                                                                            0));
-        if (writer == nullptr)
+        if (jobs.empty())
         {
-            error = u8str(u8"\u65e0\u6cd5\u521b\u5efa WAV \u5199\u5165\u5668");
-            plugin->releaseResources();
+            error = u8str(u8"\u6279\u91cf\u4efb\u52a1\u4e3a\u7a7a");
             return false;
         }
-        outputStream.release();
 
-        juce::AudioBuffer<float> buffer(bufferChannels, desiredBlockSize);
-        juce::AudioBuffer<float> dry(processChannels, desiredBlockSize);
-        juce::MidiBuffer midi;
+        const int instanceCount = juce::jmin(numWorkers, static_cast<int>(jobs.size()));
 
-        double drySumSquares = 0.0;
-        double diffSumSquares = 0.0;
-        float maxAbsDiff = 0.0f;
-        int64_t totalSamples = 0;
-
-        int64_t position = 0;
-        while (position < numSamples64)
+        std::vector<std::unique_ptr<juce::AudioPluginInstance>> instances;
+        instances.reserve(static_cast<size_t>(instanceCount));
+        for (int i = 0; i < instanceCount; ++i)
         {
-            const int numThisTime = static_cast<int>(juce::jmin<int64_t>(desiredBlockSize, numSamples64 - position));
-
-            buffer.clear();
-            reader->read(&buffer, 0, numThisTime, position, true, true);
-
-            if (numInputChannels == 1 && processChannels == 2)
-                buffer.copyFrom(1, 0, buffer, 0, 0, numThisTime);
-
-            for (int ch = 0; ch < processChannels; ++ch)
-                dry.copyFrom(ch, 0, buffer, ch, 0, numThisTime);
-
-            plugin->processBlock(buffer, midi);
-
-            for (int ch = 0; ch < processChannels; ++ch)
-            {
-                const auto* dryPtr = dry.getReadPointer(ch);
-                const auto* wetPtr = buffer.getReadPointer(ch);
-                for (int i = 0; i < numThisTime; ++i)
-                {
-                    const float d = dryPtr[i];
-                    const float w = wetPtr[i];
-                    const float diff = w - d;
-                    drySumSquares += static_cast<double>(d) * static_cast<double>(d);
-                    diffSumSquares += static_cast<double>(diff) * static_cast<double>(diff);
-                    maxAbsDiff = juce::jmax(maxAbsDiff, std::abs(diff));
-                }
-            }
-            totalSamples += static_cast<int64_t>(processChannels) * static_cast<int64_t>(numThisTime);
-
-            if (!writer->writeFromAudioSampleBuffer(buffer, 0, numThisTime))
+            auto instance = host.acquireInstance(44100.0, blockSize, error);
+            if (instance == nullptr)
             {
-                error = u8str(u8"\u5199\u5165\u8f93\u51fa\u6587\u4ef6\u5931\u8d25");
-                plugin->releaseResources();
-                plugin->setNonRealtime(false);
+                for (auto& acquired : instances)
+                    host.releaseInstance(std::move(acquired));
                 return false;
             }
-
-            position += numThisTime;
-        }
-
-        writer.reset();
-        if (!tempFile.overwriteTargetFileWithTemporary())
-        {
-            error = u8str(u8"\u65e0\u6cd5\u8986\u76d6\u5199\u5165\u8f93\u51fa\u6587\u4ef6");
-            plugin->releaseResources();
-            plugin->setNonRealtime(false);
-            return false;
-        }
-
-        plugin->releaseResources();
-        plugin->setNonRealtime(false);
-
-        if (stats != nullptr && totalSamples > 0)
-        {
-            const double dryRms = std::sqrt(drySumSquares / static_cast<double>(totalSamples));
-            const double diffRms = std::sqrt(diffSumSquares / static_cast<double>(totalSamples));
-            stats->inputRmsDb = juce::Decibels::gainToDecibels(dryRms, -300.0);
-            stats->diffRmsDb = juce::Decibels::gainToDecibels(diffRms, -300.0);
-            stats->maxAbsDiff = maxAbsDiff;
-        }
-        return true;
-    }
-
-    std::vector<float> processInterleavedFloatArray(const float* inputInterleaved,
-                                                    int numChannels,
-                                                    int numSamples,
-                                                    double sampleRate,
-                                                    juce::String& error) const
-    {
-        std::vector<float> output(static_cast<size_t>(numSamples), 0.0f);
-
-        auto* plugin = host.get();
-        if (plugin == nullptr)
-        {
-            error = u8str(u8"\u672a\u52a0\u8f7d\u63d2\u4ef6");
-            return output;
+            instances.push_back(std::move(instance));
         }
 
-        if (inputInterleaved == nullptr || numChannels <= 0 || numSamples <= 0 || sampleRate <= 0.0)
-        {
-            error = u8str(u8"\u6570\u7ec4\u8f93\u5165\u53c2\u6570\u65e0\u6548");
-            return output;
-        }
-
-        const int desiredBlockSize = juce::jlimit(64, 8192, lastBlockSize);
-        const int numPluginIns = juce::jmax(1, plugin->getTotalNumInputChannels());
-        const int numPluginOuts = juce::jmax(1, plugin->getTotalNumOutputChannels());
-
-        int processChannels = numChannels;
-        if (numChannels == 1 && numPluginOuts >= 2)
-            processChannels = 2;
-        
-        plugin->setNonRealtime(true);
-        plugin->setPlayConfigDetails(processChannels, processChannels, sampleRate, desiredBlockSize);
-        plugin->prepareToPlay(sampleRate, desiredBlockSize);
-        plugin->reset();
-        plugin->suspendProcessing(false);
+        results.resize(jobs.size());
+        std::atomic<size_t> nextJob { 0 };
 
-        const int bufferChannels = juce::jmax(processChannels, juce::jmax(numPluginIns, numPluginOuts));
-
-        juce::AudioBuffer<float> buffer(bufferChannels, desiredBlockSize);
-        juce::MidiBuffer midi;
-
-        int position = 0;
-        while (position < numSamples)
+        juce::ThreadPool pool(instanceCount);
+        for (auto& instance : instances)
         {
-            const int numThisTime = juce::jmin(desiredBlockSize, numSamples - position);
-            buffer.clear();
-
-            for (int ch = 0; ch < numChannels; ++ch)
-            {
-                auto* dst = buffer.getWritePointer(ch);
-                const float* src = inputInterleaved + static_cast<size_t>(position) * static_cast<size_t>(numChannels) + static_cast<size_t>(ch);
-                for (int i = 0; i < numThisTime; ++i)
-                    dst[i] = src[static_cast<size_t>(i) * static_cast<size_t>(numChannels)];
-            }
-            
-            if (numChannels == 1 && processChannels == 2)
-                buffer.copyFrom(1, 0, buffer, 0, 0, numThisTime);
-
-            plugin->processBlock(buffer, midi);
-
-            float* outDst = output.data() + position;
-            
-            if (processChannels == 1)
-            {
-                const auto* src = buffer.getReadPointer(0);
-                for (int i = 0; i < numThisTime; ++i)
-                    outDst[i] = src[i];
-            }
-            else
+            auto* plugin = instance.get();
+            pool.addJob([&jobs, &results, &nextJob, plugin, blockSize]
             {
-                const float scale = 1.0f / static_cast<float>(processChannels);
-                
-                const auto* src0 = buffer.getReadPointer(0);
-                for (int i = 0; i < numThisTime; ++i)
-                    outDst[i] = src0[i];
-
-                for (int ch = 1; ch < processChannels; ++ch)
+                for (;;)
                 {
-                    const auto* src = buffer.getReadPointer(ch);
-                    for (int i = 0; i < numThisTime; ++i)
-                        outDst[i] += src[i];
+                    const auto index = nextJob.fetch_add(1);
+                    if (index >= jobs.size())
+                        return;
+
+                    auto& result = results[index];
+                    result.input = jobs[index].input;
+                    result.output = jobs[index].output;
+                    result.ok = OfflineProcessor::renderFile(*plugin, blockSize, result.input, result.output, result.error);
                 }
-
-                for (int i = 0; i < numThisTime; ++i)
-                    outDst[i] *= scale;
-            }
-
-            position += numThisTime;
+            });
         }
 
-        plugin->releaseResources();
-        plugin->setNonRealtime(false);
-        return output;
-    }
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(10);
 
-    std::vector<float> processMonoFloatArray(const float* inputMono, int numSamples, double sampleRate, juce::String& error) const
-    {
-        return processInterleavedFloatArray(inputMono, 1, numSamples, sampleRate, error);
-    }
+        for (auto& instance : instances)
+            host.releaseInstance(std::move(instance));
 
-    std::vector<float> processMonoFloatArray(const float* inputMono, int numSamples, juce::String& error) const
-    {
-        return processMonoFloatArray(inputMono, numSamples, 44100.0, error);
+        return true;
     }
 
-    void setBlockSize(int newBlockSize) { lastBlockSize = newBlockSize; }
-
 private:
     PluginHost& host;
-    int lastBlockSize = 1024;
+    int numWorkers;
 };
 
 class ProcessorThread : public juce::ThreadWithProgressWindow
 {
 public:
-    ProcessorThread(OfflineProcessor& processorToUse, juce::File in, juce::File out)
+    // onProgress (optional) receives (ratio 0..1, xRealtime) so callers like
+    // the webui can poll real progress while the render runs.
+    ProcessorThread(OfflineProcessor& processorToUse, juce::File in, juce::File out,
+                    std::function<void(double, double)> onProgressToUse = {})
         : juce::ThreadWithProgressWindow(u8str(u8"\u5904\u7406\u4e2d\u2026"), true, true),
           processor(processorToUse),
           inputFile(std::move(in)),
-          outputFile(std::move(out))
+          outputFile(std::move(out)),
+          onProgress(std::move(onProgressToUse))
     {
     }
 
     void run() override
     {
         setProgress(-1.0);
-        ok = processor.processAudioFileToFile(inputFile, outputFile, error, &stats);
+
+        ok = processor.processAudioFileToFile(inputFile, outputFile, error, &stats,
+                                              [this](juce::int64 framesDone, juce::int64 totalFrames, double xRealtime)
+                                              {
+                                                  const double ratio = totalFrames > 0
+                                                                           ? static_cast<double>(framesDone) / static_cast<double>(totalFrames)
+                                                                           : 0.0;
+                                                  setProgress(ratio);
+                                                  setStatusMessage(juce::String(xRealtime, 2) + u8str(u8" \u500d\u5b9e\u65f6"));
+
+                                                  if (onProgress != nullptr)
+                                                      onProgress(ratio, xRealtime);
+                                              });
     }
 
     bool ok = false;
@@ -367,54 +152,93 @@ private:
     OfflineProcessor& processor;
     juce::File inputFile;
     juce::File outputFile;
+    std::function<void(double, double)> onProgress;
 };
 
+// Single pass over the raw UTF-8 text with std::from_chars. The old
+// StringArray tokenizer did three passes and at least two heap allocations
+// per number, which froze the UI for seconds on million-sample pastes.
 static std::vector<float> parseFloatList(const juce::String& text, juce::String& error)
 {
     std::vector<float> values;
     error.clear();
 
-    juce::String s = text;
-    s = s.replaceCharacters(",;\t\r\n", "     ");
-    s = s.trim();
+    const char* p = text.toRawUTF8();
+    const char* const end = p + std::strlen(p);
+
+    const auto isDelimiter = [](char c)
+    {
+        return c == ' ' || c == ',' || c == ';' || c == '\t' || c == '\r' || c == '\n';
+    };
 
-    if (s.isEmpty())
-        return values;
+    // One cheap counting pass so the vector is sized before any parsing.
+    size_t tokenCount = 0;
+    bool inToken = false;
+    for (const char* q = p; q != end; ++q)
+    {
+        const bool delim = isDelimiter(*q);
+        if (!delim && !inToken)
+            ++tokenCount;
+        inToken = !delim;
+    }
 
-    juce::StringArray tokens;
-    tokens.addTokens(s, " ", "");
-    tokens.removeEmptyStrings();
+    values.reserve(tokenCount);
 
-    values.reserve(static_cast<size_t>(tokens.size()));
-    for (auto& tok : tokens)
+    while (p != end)
     {
-        const auto t = tok.trim();
-        if (t.isEmpty())
-            continue;
+        while (p != end && isDelimiter(*p))
+            ++p;
+        if (p == end)
+            break;
 
-        if (!t.containsOnly("+-0123456789.eE"))
+        const char* tokenStart = p;
+        for (; p != end && !isDelimiter(*p); ++p)
         {
-            error = u8str(u8"\u8f93\u5165\u6570\u7ec4\u4e2d\u5305\u542b\u975e\u6570\u503c\u5185\u5bb9");
-            values.clear();
-            return values;
+            const char c = *p;
+            if (c != '+' && c != '-' && c != '.' && c != 'e' && c != 'E' && (c < '0' || c > '9'))
+            {
+                error = u8str(u8"\u8f93\u5165\u6570\u7ec4\u4e2d\u5305\u542b\u975e\u6570\u503c\u5185\u5bb9");
+                values.clear();
+                return values;
+            }
         }
 
-        values.push_back(static_cast<float>(t.getDoubleValue()));
+        if (*tokenStart == '+') // from_chars rejects an explicit plus sign
+            ++tokenStart;
+
+        // Tokens from the accepted charset that still don't parse (".", "e5")
+        // become 0, matching the old getDoubleValue behaviour.
+        double value = 0.0;
+        std::from_chars(tokenStart, p, value);
+        values.push_back(static_cast<float>(value));
     }
 
     return values;
 }
 
+// Formats every value into one contiguous buffer instead of growing a
+// juce::String per value; output matches the old juce::String(value, 7).
 static juce::String formatFloatList(const std::vector<float>& values)
 {
-    juce::String out;
+    if (values.empty())
+        return {};
+
+    constexpr size_t maxEntryChars = 64; // widest "%.7f" float plus ",\n"
+    std::vector<char> buffer(values.size() * maxEntryChars);
+
+    char* out = buffer.data();
     for (size_t i = 0; i < values.size(); ++i)
     {
-        out << juce::String(values[i], 7);
-        if (i + 1 < values.size())
-            out << ",\n";
+        if (i > 0)
+        {
+            *out++ = ',';
+            *out++ = '\n';
+        }
+
+        out += std::snprintf(out, maxEntryChars, "%.7f", static_cast<double>(values[i]));
     }
-    return out;
+
+    return juce::String::fromUTF8(buffer.data(), static_cast<int>(out - buffer.data()));
 }
 
 class ArrayProcessComponent final : public juce::Component
@@ -814,8 +638,7 @@ class WebMainComponent final : public juce::Component
 {
 public:
     WebMainComponent()
-        : webRoot(findWebRoot()),
-          processor(pluginHost),
+        : processor(pluginHost),
           browser(makeBrowserOptions())
     {
         addAndMakeVisible(browser);
@@ -857,17 +680,59 @@ private:
 
     static std::vector<std::byte> loadBytesFromFile(const juce::File& file)
     {
-        juce::MemoryBlock mb;
-        if (!file.loadFileAsData(mb))
+        juce::FileInputStream stream(file);
+        if (!stream.openedOk())
             return {};
 
-        std::vector<std::byte> out;
-        out.resize(mb.getSize());
-        if (mb.getSize() > 0)
-            std::memcpy(out.data(), mb.getData(), mb.getSize());
+        std::vector<std::byte> out(static_cast<size_t>(juce::jmax<juce::int64>(0, stream.getTotalLength())));
+        if (!out.empty() && stream.read(out.data(), static_cast<int>(out.size())) != static_cast<int>(out.size()))
+            return {};
         return out;
     }
 
+    // Resolved lazily on the first resource request (i.e. off the
+    // constructor and on the provider thread) and persisted in the app's
+    // properties file: on network-mounted shares every existsAsFile is a
+    // slow RPC, so later launches validate the stored path with a single
+    // stat instead of re-walking the directory tree.
+    juce::File getWebRoot()
+    {
+        const juce::ScopedLock lock(webRootLock);
+
+        if (webRootResolved)
+            return webRoot;
+
+        auto properties = createPropertiesFile();
+        const auto stored = properties->getValue("webRoot");
+        if (stored.isNotEmpty() && juce::File(stored).getChildFile("index.html").existsAsFile())
+        {
+            webRoot = juce::File(stored);
+            webRootResolved = true;
+            return webRoot;
+        }
+
+        webRoot = findWebRoot();
+        webRootResolved = true;
+
+        if (webRoot.exists())
+        {
+            properties->setValue("webRoot", webRoot.getFullPathName());
+            properties->saveIfNeeded();
+        }
+
+        return webRoot;
+    }
+
+    static std::unique_ptr<juce::PropertiesFile> createPropertiesFile()
+    {
+        juce::PropertiesFile::Options options;
+        options.applicationName = "VSTHostApp";
+        options.filenameSuffix = ".settings";
+        options.folderName = "VSTHostApp";
+        options.osxLibrarySubFolder = "Application Support";
+        return std::make_unique<juce::PropertiesFile>(options);
+    }
+
     juce::File findWebRoot() const
     {
         auto tryFindFrom = [](juce::File dir) -> juce::File
@@ -901,7 +766,7 @@ private:
         return {};
     }
 
-    std::optional<juce::WebBrowserComponent::Resource> provideResource(const juce::String& path) const
+    std::optional<juce::WebBrowserComponent::Resource> provideResource(const juce::String& path)
     {
         auto requestPath = path.isEmpty() ? "/" : path;
         if (!requestPath.startsWithChar('/'))
@@ -915,27 +780,43 @@ private:
 
         const auto relative = requestPath.substring(1);
 
-        // Try loading from BinaryData first
+        // Served from the cache after the first request: the browser re-asks
+        // for every asset on each navigation, and re-copying app.js out of
+        // BinaryData each time showed up as startup lag on slow machines.
+        {
+            const juce::ScopedLock lock(resourceCacheLock);
+            const auto cached = resourceCache.find(relative);
+            if (cached != resourceCache.end())
+                return juce::WebBrowserComponent::Resource { cached->second.data, cached->second.mimeType };
+        }
+
+        // BinaryData assets are immutable: copy out once, cache forever.
         {
             juce::String resourceName = relative;
             resourceName = resourceName.replaceCharacter('.', '_');
             resourceName = resourceName.replaceCharacter('-', '_');
-            
+
             int size = 0;
             if (const char* data = WebUIBinaryData::getNamedResource(resourceName.toRawUTF8(), size))
             {
-                juce::WebBrowserComponent::Resource res;
-                res.data.resize(size);
-                std::memcpy(res.data.data(), data, size);
-                res.mimeType = getMimeTypeForFile(juce::File(relative)); // Just for mime type detection
+                CachedResource cached;
+                cached.data.resize(static_cast<size_t>(size));
+                std::memcpy(cached.data.data(), data, static_cast<size_t>(size));
+                cached.mimeType = getMimeTypeForFile(juce::File(relative)); // Just for mime type detection
+
+                juce::WebBrowserComponent::Resource res { cached.data, cached.mimeType };
+
+                const juce::ScopedLock lock(resourceCacheLock);
+                resourceCache[relative] = std::move(cached);
                 return res;
             }
         }
 
-        // Fallback to local file system (for development)
-        if (webRoot.exists())
+        // Fallback to local file system (for development). Deliberately not
+        // cached, so edits show up on the next reload.
+        if (const auto root = getWebRoot(); root.exists())
         {
-            const auto file = webRoot.getChildFile(relative);
+            const auto file = root.getChildFile(relative);
             if (file.existsAsFile())
             {
                 juce::WebBrowserComponent::Resource res;
@@ -978,6 +859,30 @@ private:
                                                    const int newBlockSize = juce::jmax(64, static_cast<int>(args[0]));
                                                    lastBlockSize = newBlockSize;
                                                    processor.setBlockSize(newBlockSize);
+                                                   completion(makeStateVar());
+                                               })
+                           .withNativeFunction("setStatsEnabled",
+                                               [this](const juce::Array<juce::var>& args, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+                                               {
+                                                   processor.setStatsEnabled(args.size() > 0 && static_cast<bool>(args[0]));
+                                                   completion(makeStateVar());
+                                               })
+                           .withNativeFunction("setBitDepth",
+                                               [this](const juce::Array<juce::var>& args, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+                                               {
+                                                   if (args.size() < 1)
+                                                   {
+                                                       completion(makeErrorVar(u8str(u8"\u7f3a\u5c11 bitDepth")));
+                                                       return;
+                                                   }
+
+                                                   juce::String error;
+                                                   if (!processor.setOutputBitDepth(static_cast<int>(args[0]), error))
+                                                   {
+                                                       completion(makeErrorVar(error));
+                                                       return;
+                                                   }
+
                                                    completion(makeStateVar());
                                                })
                            .withNativeFunction("choosePlugin",
@@ -998,6 +903,31 @@ private:
                                                        return;
                                                    }
 
+                                                   completion(makeStateVar());
+                                               })
+                           .withNativeFunction("addPluginToChain",
+                                               [this](const juce::Array<juce::var>&, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+                                               {
+                                                   if (pluginHost.get() == nullptr)
+                                                   {
+                                                       completion(makeErrorVar(u8str(u8"\u8bf7\u5148\u52a0\u8f7d\u63d2\u4ef6")));
+                                                       return;
+                                                   }
+
+                                                   juce::FileChooser chooser(u8str(u8"\u9009\u62e9\u63d2\u4ef6\u6587\u4ef6\uff08VST3\uff09"), {}, "*.vst3");
+                                                   if (!chooser.browseForFileToOpen())
+                                                   {
+                                                       completion(makeStateVar());
+                                                       return;
+                                                   }
+
+                                                   juce::String error;
+                                                   if (!pluginHost.addPluginToChain(chooser.getResult(), 44100.0, lastBlockSize, error))
+                                                   {
+                                                       completion(makeErrorVar(error));
+                                                       return;
+                                                   }
+
                                                    completion(makeStateVar());
                                                })
                            .withNativeFunction("openPluginEditor",
@@ -1020,6 +950,56 @@ private:
                                                    editorWindow = std::make_unique<PluginEditorWindow>(*plugin);
                                                    completion(makeOkVar());
                                                })
+                           .withNativeFunction("savePluginState",
+                                               [this](const juce::Array<juce::var>&, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+                                               {
+                                                   if (pluginHost.get() == nullptr)
+                                                   {
+                                                       completion(makeErrorVar(u8str(u8"\u8bf7\u5148\u52a0\u8f7d\u63d2\u4ef6")));
+                                                       return;
+                                                   }
+
+                                                   juce::FileChooser chooser(u8str(u8"\u4fdd\u5b58\u63d2\u4ef6\u72b6\u6001\u6587\u4ef6"), {}, "*.bin");
+                                                   if (!chooser.browseForFileToSave(true))
+                                                   {
+                                                       completion(makeStateVar());
+                                                       return;
+                                                   }
+
+                                                   juce::String error;
+                                                   if (!pluginHost.savePluginState(chooser.getResult().withFileExtension("bin"), error))
+                                                   {
+                                                       completion(makeErrorVar(error));
+                                                       return;
+                                                   }
+
+                                                   completion(makeStateVar());
+                                               })
+                           .withNativeFunction("loadPluginState",
+                                               [this](const juce::Array<juce::var>&, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+                                               {
+                                                   if (pluginHost.get() == nullptr)
+                                                   {
+                                                       completion(makeErrorVar(u8str(u8"\u8bf7\u5148\u52a0\u8f7d\u63d2\u4ef6")));
+                                                       return;
+                                                   }
+
+                                                   juce::FileChooser chooser(u8str(u8"\u9009\u62e9\u63d2\u4ef6\u72b6\u6001\u6587\u4ef6"), {}, "*.bin");
+                                                   if (!chooser.browseForFileToOpen())
+                                                   {
+                                                       completion(makeStateVar());
+                                                       return;
+                                                   }
+
+                                                   juce::String error;
+                                                   if (!pluginHost.loadPluginState(chooser.getResult(), error))
+                                                   {
+                                                       completion(makeErrorVar(error));
+                                                       return;
+                                                   }
+
+                                                   completion(makeStateVar());
+                                               })
                            .withNativeFunction("chooseInputAudio",
                                                [this](const juce::Array<juce::var>&, juce::WebBrowserComponent::NativeFunctionCompletion completion)
                                                {
@@ -1069,8 +1049,14 @@ private:
                                                    }
 
                                                    processor.setBlockSize(lastBlockSize);
-                                                   ProcessorThread thread(processor, inputFile, outputFile);
+                                                   ProcessorThread thread(processor, inputFile, outputFile,
+                                                                          [this](double ratio, double xRealtime)
+                                                                          {
+                                                                              renderProgress.store(ratio);
+                                                                              renderXRealtime.store(xRealtime);
+                                                                          });
                                                    thread.runThread();
+                                                   renderProgress.store(-1.0);
 
                                                    if (!thread.ok)
                                                    {
@@ -1081,17 +1067,30 @@ private:
                                                    auto result = makeOkVar();
                                                    if (auto* obj = result.getDynamicObject())
                                                    {
-                                                       auto stats = std::make_unique<juce::DynamicObject>();
-                                                       stats->setProperty("outputChannels", thread.stats.outputChannels);
-                                                       stats->setProperty("inputRmsDb", thread.stats.inputRmsDb);
-                                                       stats->setProperty("diffRmsDb", thread.stats.diffRmsDb);
-                                                       stats->setProperty("maxAbsDiff", thread.stats.maxAbsDiff);
-                                                       obj->setProperty("stats", juce::var(stats.release()));
                                                        obj->setProperty("outputPath", outputFile.getFullPathName());
+
+                                                       if (processor.isStatsEnabled())
+                                                       {
+                                                           auto stats = std::make_unique<juce::DynamicObject>();
+                                                           stats->setProperty("outputChannels", thread.stats.outputChannels);
+                                                           stats->setProperty("inputRmsDb", thread.stats.inputRmsDb);
+                                                           stats->setProperty("diffRmsDb", thread.stats.diffRmsDb);
+                                                           stats->setProperty("maxAbsDiff", thread.stats.maxAbsDiff);
+                                                           stats->setProperty("outputPeak", thread.stats.outputPeak);
+                                                           stats->setProperty("clippedSamples", thread.stats.clippedSamples);
+
+                                                           auto timing = std::make_unique<juce::DynamicObject>();
+                                                           timing->setProperty("read", makeStageTimingVar(thread.stats.readTiming));
+                                                           timing->setProperty("process", makeStageTimingVar(thread.stats.processTiming));
+                                                           timing->setProperty("write", makeStageTimingVar(thread.stats.writeTiming));
+                                                           stats->setProperty("timing", juce::var(timing.release()));
+
+                                                           obj->setProperty("stats", juce::var(stats.release()));
+                                                       }
                                                    }
                                                    completion(result);
                                                })
-                           .withNativeFunction("processArray",
+                           .withNativeFunction("processArrayBinary",
                                                [this](const juce::Array<juce::var>& args, juce::WebBrowserComponent::NativeFunctionCompletion completion)
                                                {
                                                    auto* plugin = pluginHost.get();
@@ -1109,24 +1108,26 @@ private:
 
                                                    const double sr = static_cast<double>(args[0]);
                                                    const double sampleRate = sr > 0.0 ? sr : 44100.0;
-                                                   const juce::String text = args[1].toString();
 
-                                                   juce::String parseError;
-                                                   auto input = parseFloatList(text, parseError);
-                                                   if (parseError.isNotEmpty())
+                                                   // Raw little-endian float32 as base64: no per-sample string
+                                                   // work on either side of the bridge.
+                                                   juce::MemoryOutputStream decoded;
+                                                   if (!juce::Base64::convertFromBase64(decoded, args[1].toString()))
                                                    {
-                                                       completion(makeErrorVar(parseError));
+                                                       completion(makeErrorVar(u8str(u8"\u65e0\u6cd5\u89e3\u7801 base64 \u6570\u636e")));
                                                        return;
                                                    }
 
-                                                   if (input.empty())
+                                                   const int numSamples = static_cast<int>(decoded.getDataSize() / sizeof(float));
+                                                   if (numSamples <= 0)
                                                    {
                                                        completion(makeErrorVar(u8str(u8"\u8bf7\u8f93\u5165\u81f3\u5c11\u4e00\u4e2a float")));
                                                        return;
                                                    }
 
                                                    juce::String error;
-                                                   auto out = processor.processMonoFloatArray(input.data(), static_cast<int>(input.size()), sampleRate, error);
+                                                   auto out = processor.processMonoFloatArray(static_cast<const float*>(decoded.getData()),
+                                                                                              numSamples, sampleRate, error);
                                                    if (error.isNotEmpty())
                                                    {
                                                        completion(makeErrorVar(error));
@@ -1135,17 +1136,116 @@ private:
 
                                                    auto result = makeOkVar();
                                                    if (auto* obj = result.getDynamicObject())
-                                                       obj->setProperty("outputText", formatFloatList(out));
+                                                       obj->setProperty("outputBase64", juce::Base64::toBase64(out.data(), out.size() * sizeof(float)));
                                                    completion(result);
-                                               });
+                                               })
+                           .withNativeFunction("streamBegin",
+                                               [this](const juce::Array<juce::var>& args, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+                                               {
+                                                   const double sr = args.size() > 0 ? static_cast<double>(args[0]) : 44100.0;
+                                                   const double sampleRate = sr > 0.0 ? sr : 44100.0;
 
-        juce::WebBrowserComponent::Options::WinWebView2 winOpts;
-        winOpts = winOpts.withStatusBarDisabled()
-                      .withBuiltInErrorPageDisabled()
-                      .withBackgroundColour(juce::Colours::transparentBlack)
-                      .withUserDataFolder(juce::File::getSpecialLocation(juce::File::tempDirectory)
-                                              .getChildFile("VSTHostAppWebView2"));
-        options = options.withWinWebView2Options(winOpts);
+                                                   juce::String error;
+                                                   if (!processor.beginStream(sampleRate, 1, error))
+                                                   {
+                                                       completion(makeErrorVar(error));
+                                                       return;
+                                                   }
+
+                                                   completion(makeOkVar());
+                                               })
+                           .withNativeFunction("streamPush",
+                                               [this](const juce::Array<juce::var>& args, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+                                               {
+                                                   if (args.size() < 1)
+                                                   {
+                                                       completion(makeErrorVar(u8str(u8"\u7f3a\u5c11\u53c2\u6570")));
+                                                       return;
+                                                   }
+
+                                                   juce::MemoryOutputStream decoded;
+                                                   if (!juce::Base64::convertFromBase64(decoded, args[0].toString()))
+                                                   {
+                                                       completion(makeErrorVar(u8str(u8"\u65e0\u6cd5\u89e3\u7801 base64 \u6570\u636e")));
+                                                       return;
+                                                   }
+
+                                                   const int numSamples = static_cast<int>(decoded.getDataSize() / sizeof(float));
+
+                                                   juce::String error;
+                                                   std::vector<float> out;
+                                                   if (!processor.pushStreamBlock(static_cast<const float*>(decoded.getData()), numSamples, out, error))
+                                                   {
+                                                       completion(makeErrorVar(error));
+                                                       return;
+                                                   }
+
+                                                   auto result = makeOkVar();
+                                                   if (auto* obj = result.getDynamicObject())
+                                                       obj->setProperty("outputBase64", juce::Base64::toBase64(out.data(), out.size() * sizeof(float)));
+                                                   completion(result);
+                                               })
+                           .withNativeFunction("streamEnd",
+                                               [this](const juce::Array<juce::var>&, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+                                               {
+                                                   processor.endStream();
+                                                   completion(makeOkVar());
+                                               })
+                           .withNativeFunction("processArray",
+                                               [this](const juce::Array<juce::var>& args, juce::WebBrowserComponent::NativeFunctionCompletion completion)
+                                               {
+                                                   auto* plugin = pluginHost.get();
+                                                   if (plugin == nullptr)
+                                                   {
+                                                       completion(makeErrorVar(u8str(u8"\u8bf7\u5148\u52a0\u8f7d\u63d2\u4ef6")));
+                                                       return;
+                                                   }
+
+                                                   if (args.size() < 2)
+                                                   {
+                                                       completion(makeErrorVar(u8str(u8"\u7f3a\u5c11\u53c2\u6570")));
+                                                       return;
+                                                   }
+
+                                                   const double sr = static_cast<double>(args[0]);
+                                                   const double sampleRate = sr > 0.0 ? sr : 44100.0;
+                                                   const juce::String text = args[1].toString();
+
+                                                   juce::String parseError;
+                                                   auto input = parseFloatList(text, parseError);
+                                                   if (parseError.isNotEmpty())
+                                                   {
+                                                       completion(makeErrorVar(parseError));
+                                                       return;
+                                                   }
+
+                                                   if (input.empty())
+                                                   {
+                                                       completion(makeErrorVar(u8str(u8"\u8bf7\u8f93\u5165\u81f3\u5c11\u4e00\u4e2a float")));
+                                                       return;
+                                                   }
+
+                                                   juce::String error;
+                                                   auto out = processor.processMonoFloatArray(input.data(), static_cast<int>(input.size()), sampleRate, error);
+                                                   if (error.isNotEmpty())
+                                                   {
+                                                       completion(makeErrorVar(error));
+                                                       return;
+                                                   }
+
+                                                   auto result = makeOkVar();
+                                                   if (auto* obj = result.getDynamicObject())
+                                                       obj->setProperty("outputText", formatFloatList(out));
+                                                   completion(result);
+                                               });
+
+        juce::WebBrowserComponent::Options::WinWebView2 winOpts;
+        winOpts = winOpts.withStatusBarDisabled()
+                      .withBuiltInErrorPageDisabled()
+                      .withBackgroundColour(juce::Colours::transparentBlack)
+                      .withUserDataFolder(juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                              .getChildFile("VSTHostAppWebView2"));
+        options = options.withWinWebView2Options(winOpts);
 
         return options;
     }
@@ -1165,14 +1265,29 @@ private:
         return juce::var(obj.release());
     }
 
+    static juce::var makeStageTimingVar(const OfflineProcessor::StageTiming& timing)
+    {
+        auto obj = std::make_unique<juce::DynamicObject>();
+        obj->setProperty("blocks", timing.numBlocks);
+        obj->setProperty("totalMs", timing.totalMs);
+        obj->setProperty("p50Ms", timing.percentileMs(0.50));
+        obj->setProperty("p99Ms", timing.percentileMs(0.99));
+        obj->setProperty("maxMs", timing.maxMs);
+        return juce::var(obj.release());
+    }
+
     juce::var makeStateVar() const
     {
         auto obj = std::make_unique<juce::DynamicObject>();
         obj->setProperty("ok", true);
-        obj->setProperty("pluginName", pluginHost.get() != nullptr ? pluginHost.getDescription().name : u8str(u8"\u672a\u52a0\u8f7d"));
+        obj->setProperty("pluginName", pluginHost.get() != nullptr ? pluginHost.getChainNames().joinIntoString(u8str(u8" \u2192 ")) : u8str(u8"\u672a\u52a0\u8f7d"));
         obj->setProperty("inputPath", inputFile.getFullPathName());
         obj->setProperty("outputPath", outputFile.getFullPathName());
         obj->setProperty("blockSize", lastBlockSize);
+        obj->setProperty("bitDepth", processor.getOutputBitDepth());
+        obj->setProperty("statsEnabled", processor.isStatsEnabled());
+        obj->setProperty("progress", renderProgress.load());
+        obj->setProperty("xRealtime", renderXRealtime.load());
         return juce::var(obj.release());
     }
 
@@ -1194,11 +1309,27 @@ private:
         void closeButtonPressed() override { setVisible(false); }
     };
 
+    struct CachedResource
+    {
+        std::vector<std::byte> data;
+        juce::String mimeType;
+    };
+
+    juce::CriticalSection webRootLock;
     juce::File webRoot;
+    bool webRootResolved = false;
+
+    juce::CriticalSection resourceCacheLock;
+    std::map<juce::String, CachedResource> resourceCache;
     PluginHost pluginHost;
     int lastBlockSize = 1024;
     OfflineProcessor processor;
 
+    // Updated from the render thread, polled via refreshState while the
+    // modal progress loop pumps messages. -1 means no render in flight.
+    std::atomic<double> renderProgress { -1.0 };
+    std::atomic<double> renderXRealtime { 0.0 };
+
     juce::WebBrowserComponent browser;
 
     juce::File inputFile;
@@ -1206,22 +1337,1083 @@ private:
 
     std::unique_ptr<PluginEditorWindow> editorWindow;
 };
-} // namespace vsthost
+// Headless render path for batch scripts: no window, no WebView2, just
+// load -> process -> exit. Keeps per-file invocation cost down to plugin
+// load plus the render itself.
+static juce::File resolvePathArgument(const juce::String& value)
+{
+    return juce::File::getCurrentWorkingDirectory().getChildFile(value.unquoted());
+}
 
-class VSTHostApplication final : public juce::JUCEApplication
+// Collects every value of a repeatable option (--plugin can be given several
+// times to build a processing chain).
+static juce::StringArray getAllValuesForOption(const juce::ArgumentList& args, const juce::String& option)
 {
-public:
-    const juce::String getApplicationName() override { return "VSTHostApp"; }
-    const juce::String getApplicationVersion() override { return "0.1.0"; }
-    bool moreThanOneInstanceAllowed() override { return true; }
+    juce::StringArray values;
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto text = args[i].text;
+        if (text == option)
+        {
+            if (i + 1 < args.size())
+                values.add(args[i + 1].text.unquoted());
+        }
+        else if (text.startsWith(option + "="))
+        {
+            values.add(text.fromFirstOccurrenceOf("=", false, false).unquoted());
+        }
+    }
+    return values;
+}
+
+static int runHeadlessRender(const juce::ArgumentList& args)
+{
+    const auto pluginPaths = getAllValuesForOption(args, "--plugin");
+    const auto inputPath = args.getValueForOption("--in");
+    const auto outputPath = args.getValueForOption("--out");
+
+    if (pluginPaths.isEmpty() || inputPath.isEmpty() || outputPath.isEmpty())
+    {
+        std::cerr << "Usage: VSTHostApp --plugin <plugin.vst3> [--plugin <next.vst3> ...] --in <input> --out <output.wav> [--block-size N] [--bit-depth 16|24|32] [--target-sample-rate N] [--normalize] [--state <state.bin>] [--param index:time:value ...] [--variant index=value,... ...]\n";
+        return 2;
+    }
+
+    int blockSize = 1024;
+    if (args.containsOption("--block-size"))
+        blockSize = juce::jmax(64, args.getValueForOption("--block-size").getIntValue());
+
+    int bitDepth = 24;
+    if (args.containsOption("--bit-depth"))
+        bitDepth = args.getValueForOption("--bit-depth").getIntValue();
+
+    PluginHost pluginHost;
+    OfflineProcessor processor(pluginHost);
+    processor.setBlockSize(blockSize);
+
+    juce::String error;
+    if (!processor.setOutputBitDepth(bitDepth, error))
+    {
+        std::cerr << error.toStdString() << "\n";
+        return 2;
+    }
+
+    juce::File stateFile;
+    if (args.containsOption("--state"))
+        stateFile = resolvePathArgument(args.getValueForOption("--state"));
+
+    if (!pluginHost.loadPluginFromFile(resolvePathArgument(pluginPaths[0]), 44100.0, blockSize, error, stateFile))
+    {
+        std::cerr << error.toStdString() << "\n";
+        return 1;
+    }
+
+    for (int i = 1; i < pluginPaths.size(); ++i)
+    {
+        if (!pluginHost.addPluginToChain(resolvePathArgument(pluginPaths[i]), 44100.0, blockSize, error))
+        {
+            std::cerr << error.toStdString() << "\n";
+            return 1;
+        }
+    }
+
+    // Repeatable --param index:time:value builds an automation lane applied
+    // to the first plugin during the render (values normalized 0..1).
+    const auto paramValues = getAllValuesForOption(args, "--param");
+    if (!paramValues.isEmpty())
+    {
+        std::vector<OfflineProcessor::AutomationPoint> points;
+        for (const auto& value : paramValues)
+        {
+            const auto parts = juce::StringArray::fromTokens(value, ":", {});
+            if (parts.size() != 3)
+            {
+                std::cerr << "--param expects index:time:value\n";
+                return 2;
+            }
+
+            points.push_back({ parts[0].getIntValue(), parts[1].getDoubleValue(), parts[2].getFloatValue() });
+        }
+
+        if (args.containsOption("--parallel"))
+        {
+            std::cerr << "--param cannot be combined with --parallel\n";
+            return 2;
+        }
+
+        processor.setAutomationPoints(std::move(points));
+    }
+
+    // --target-sample-rate resamples inside the render, so a mixed-rate
+    // library comes out at one rate without a separate conversion pass.
+    if (args.containsOption("--target-sample-rate"))
+    {
+        if (args.containsOption("--parallel"))
+        {
+            std::cerr << "--target-sample-rate cannot be combined with --parallel\n";
+            return 2;
+        }
+
+        if (!processor.setTargetSampleRate(args.getValueForOption("--target-sample-rate").getDoubleValue(), error))
+        {
+            std::cerr << error.toStdString() << "\n";
+            return 2;
+        }
+    }
+
+    // --normalize scales the output so its peak hits full scale, reusing
+    // the peak measured during the render itself.
+    if (args.containsOption("--normalize"))
+    {
+        if (args.containsOption("--parallel"))
+        {
+            std::cerr << "--normalize cannot be combined with --parallel\n";
+            return 2;
+        }
+
+        processor.setNormalizeEnabled(true);
+    }
+
+    // Repeatable --variant index=value[,index=value...] renders one output
+    // per variant from a single decode pass; outputs are derived from --out
+    // as <name>_v<N>.<ext>.
+    const auto variantValues = getAllValuesForOption(args, "--variant");
+    if (!variantValues.isEmpty())
+    {
+        if (args.containsOption("--parallel") || !paramValues.isEmpty()
+            || args.containsOption("--target-sample-rate") || args.containsOption("--normalize"))
+        {
+            std::cerr << "--variant cannot be combined with --parallel, --param, --target-sample-rate or --normalize\n";
+            return 2;
+        }
+
+        const auto outputFile = resolvePathArgument(outputPath);
+        std::vector<OfflineProcessor::Variant> variants;
+        for (const auto& value : variantValues)
+        {
+            OfflineProcessor::Variant variant;
+            for (const auto& token : juce::StringArray::fromTokens(value, ",", {}))
+            {
+                const auto parts = juce::StringArray::fromTokens(token, "=", {});
+                if (parts.size() != 2)
+                {
+                    std::cerr << "--variant expects index=value[,index=value...]\n";
+                    return 2;
+                }
+
+                variant.settings.push_back({ parts[0].getIntValue(), parts[1].getFloatValue() });
+            }
+
+            variant.output = outputFile.getSiblingFile(outputFile.getFileNameWithoutExtension()
+                                                       + "_v" + juce::String(variants.size() + 1)
+                                                       + outputFile.getFileExtension());
+            variants.push_back(std::move(variant));
+        }
+
+        if (!processor.renderVariants(resolvePathArgument(inputPath), variants, error))
+        {
+            std::cerr << error.toStdString() << "\n";
+            return 1;
+        }
+
+        for (const auto& variant : variants)
+            std::cout << variant.output.getFullPathName().toStdString() << "\n";
+        return 0;
+    }
+
+    // --parallel N splits the file into overlapping chunks rendered on N
+    // independent instances; --overlap controls the priming/crossfade length.
+    if (args.containsOption("--parallel"))
+    {
+        const int numWorkers = juce::jmax(1, args.getValueForOption("--parallel").getIntValue());
+
+        double overlapSeconds = 1.0;
+        if (args.containsOption("--overlap"))
+            overlapSeconds = juce::jmax(0.0, args.getValueForOption("--overlap").getDoubleValue());
+
+        if (!OfflineProcessor::renderFileChunkedParallel(pluginHost, blockSize,
+                                                         resolvePathArgument(inputPath), resolvePathArgument(outputPath),
+                                                         numWorkers, overlapSeconds, error, bitDepth))
+        {
+            std::cerr << error.toStdString() << "\n";
+            return 1;
+        }
+
+        return 0;
+    }
+
+    // Stats cost a per-block dry copy and comparison, so they are opt-in.
+    if (args.containsOption("--stats"))
+    {
+        OfflineProcessor::ProcessStats stats;
+        if (!processor.processAudioFileToFile(resolvePathArgument(inputPath), resolvePathArgument(outputPath),
+                                              error, &stats))
+        {
+            std::cerr << error.toStdString() << "\n";
+            return 1;
+        }
+
+        std::cout << "outputChannels=" << stats.outputChannels
+                  << " inputRmsDb=" << stats.inputRmsDb
+                  << " diffRmsDb=" << stats.diffRmsDb
+                  << " maxAbsDiff=" << stats.maxAbsDiff
+                  << " outputPeak=" << stats.outputPeak
+                  << " clippedSamples=" << stats.clippedSamples << "\n";
+        return 0;
+    }
+
+    if (!processor.processAudioFileToFile(resolvePathArgument(inputPath), resolvePathArgument(outputPath), error))
+    {
+        std::cerr << error.toStdString() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
+
+// MIDI-driven render: fires a MIDI file at an instrument plugin and records
+// the synthesized output plus a tail.
+static int runHeadlessMidiRender(const juce::ArgumentList& args)
+{
+    const auto pluginPaths = getAllValuesForOption(args, "--plugin");
+    const auto midiPath = args.getValueForOption("--midi");
+    const auto outputPath = args.getValueForOption("--out");
+
+    if (pluginPaths.isEmpty() || midiPath.isEmpty() || outputPath.isEmpty())
+    {
+        std::cerr << "Usage: VSTHostApp --midi <input.mid> --plugin <plugin.vst3> [--plugin <next.vst3> ...] --out <output.wav> [--tail seconds] [--sample-rate N] [--block-size N] [--bit-depth 16|24|32] [--state <state.bin>]\n";
+        return 2;
+    }
+
+    int blockSize = 1024;
+    if (args.containsOption("--block-size"))
+        blockSize = juce::jmax(64, args.getValueForOption("--block-size").getIntValue());
+
+    double sampleRate = 44100.0;
+    if (args.containsOption("--sample-rate"))
+        sampleRate = juce::jmax(8000.0, args.getValueForOption("--sample-rate").getDoubleValue());
+
+    double tailSeconds = 2.0;
+    if (args.containsOption("--tail"))
+        tailSeconds = juce::jmax(0.0, args.getValueForOption("--tail").getDoubleValue());
+
+    PluginHost pluginHost;
+    OfflineProcessor processor(pluginHost);
+    processor.setBlockSize(blockSize);
+
+    juce::String error;
+    if (args.containsOption("--bit-depth")
+        && !processor.setOutputBitDepth(args.getValueForOption("--bit-depth").getIntValue(), error))
+    {
+        std::cerr << error.toStdString() << "\n";
+        return 2;
+    }
+
+    juce::File stateFile;
+    if (args.containsOption("--state"))
+        stateFile = resolvePathArgument(args.getValueForOption("--state"));
+
+    if (!pluginHost.loadPluginFromFile(resolvePathArgument(pluginPaths[0]), sampleRate, blockSize, error, stateFile))
+    {
+        std::cerr << error.toStdString() << "\n";
+        return 1;
+    }
+
+    for (int i = 1; i < pluginPaths.size(); ++i)
+    {
+        if (!pluginHost.addPluginToChain(resolvePathArgument(pluginPaths[i]), sampleRate, blockSize, error))
+        {
+            std::cerr << error.toStdString() << "\n";
+            return 1;
+        }
+    }
 
-    void initialise(const juce::String&) override
+    if (!processor.renderMidiFileToFile(resolvePathArgument(midiPath), resolvePathArgument(outputPath),
+                                        sampleRate, tailSeconds, error))
     {
+        std::cerr << error.toStdString() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
+
+// Manifest-driven batch for heterogeneous workloads: a JSON array of jobs,
+// each with its own block size, bit depth and optional plugin state blob.
+// Jobs are sorted longest-first and the workers pull from a shared index,
+// so an hour-long stem starts immediately and never strands the 2-second
+// hits queued behind it; per-job wall time goes to a results file so
+// throughput regressions show up as diffs between runs.
+//
+//   [{"input":"a.wav","output":"a_out.wav","blockSize":2048,
+//     "bitDepth":32,"state":"<base64>"}, ...]
+static int runHeadlessManifest(const juce::ArgumentList& args)
+{
+    const auto manifestPath = args.getValueForOption("--manifest");
+    const auto pluginPath = args.getValueForOption("--plugin");
+
+    if (manifestPath.isEmpty() || pluginPath.isEmpty())
+    {
+        std::cerr << "Usage: VSTHostApp --manifest <jobs.json> --plugin <plugin.vst3> [--jobs N] [--results <results.json>] [--state <state.bin>]\n";
+        return 2;
+    }
+
+    const auto manifestFile = resolvePathArgument(manifestPath);
+    const auto parsed = juce::JSON::parse(manifestFile.loadFileAsString());
+    const auto* jobArray = parsed.getArray();
+    if (jobArray == nullptr || jobArray->isEmpty())
+    {
+        std::cerr << u8str(u8"\u6e05\u5355\u4e3a\u7a7a\u6216\u4e0d\u662f JSON \u6570\u7ec4").toStdString() << "\n";
+        return 1;
+    }
+
+    struct ManifestJob
+    {
+        juce::File input;
+        juce::File output;
+        int blockSize = 1024;
+        int bitDepth = 24;
+        juce::MemoryBlock state;
+    };
+
+    std::vector<ManifestJob> jobs;
+    for (const auto& entry : *jobArray)
+    {
+        ManifestJob job;
+        job.input = resolvePathArgument(entry.getProperty("input", {}).toString());
+        job.output = resolvePathArgument(entry.getProperty("output", {}).toString());
+        job.blockSize = juce::jmax(64, static_cast<int>(entry.getProperty("blockSize", 1024)));
+        job.bitDepth = static_cast<int>(entry.getProperty("bitDepth", 24));
+
+        const auto stateBase64 = entry.getProperty("state", {}).toString();
+        if (stateBase64.isNotEmpty())
+        {
+            juce::MemoryOutputStream decoded;
+            if (juce::Base64::convertFromBase64(decoded, stateBase64))
+                job.state = decoded.getMemoryBlock();
+        }
+
+        if (job.input == juce::File() || job.output == juce::File()
+            || !OfflineProcessor::isSupportedBitDepth(job.bitDepth))
+        {
+            std::cerr << u8str(u8"\u6e05\u5355\u4efb\u52a1\u7f3a\u5c11 input/output \u6216\u4f4d\u6df1\u5ea6\u65e0\u6548").toStdString() << "\n";
+            return 1;
+        }
+
+        jobs.push_back(std::move(job));
+    }
+
+    // Longest first: with workers pulling from a shared index this keeps
+    // cores busy until the tail of the schedule.
+    std::sort(jobs.begin(), jobs.end(),
+              [](const ManifestJob& a, const ManifestJob& b) { return a.input.getSize() > b.input.getSize(); });
+
+    int numWorkers = juce::SystemStats::getNumCpus();
+    if (args.containsOption("--jobs"))
+        numWorkers = juce::jmax(1, args.getValueForOption("--jobs").getIntValue());
+    numWorkers = juce::jmin(numWorkers, static_cast<int>(jobs.size()));
+
+    // --state provides a baseline applied to every worker instance; a job's
+    // own base64 "state" still wins for that job.
+    juce::File stateFile;
+    if (args.containsOption("--state"))
+        stateFile = resolvePathArgument(args.getValueForOption("--state"));
+
+    PluginHost pluginHost;
+    juce::String error;
+    if (!pluginHost.loadPluginFromFile(resolvePathArgument(pluginPath), 44100.0, 1024, error, stateFile))
+    {
+        std::cerr << error.toStdString() << "\n";
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<juce::AudioPluginInstance>> instances;
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto instance = pluginHost.acquireInstance(44100.0, 1024, error);
+        if (instance == nullptr)
+        {
+            std::cerr << error.toStdString() << "\n";
+            return 1;
+        }
+        instances.push_back(std::move(instance));
+    }
+
+    struct JobResult
+    {
+        bool ok = false;
+        juce::String error;
+        double seconds = 0.0;
+    };
+
+    std::vector<JobResult> results(jobs.size());
+    std::atomic<size_t> nextJob { 0 };
+
+    {
+        juce::ThreadPool pool(numWorkers);
+        for (auto& instance : instances)
+        {
+            auto* plugin = instance.get();
+            pool.addJob([&jobs, &results, &nextJob, plugin]
+            {
+                // The state the worker was handed out with (--state already
+                // applied) is the baseline; a job's own blob only wins for
+                // that job, so restore the baseline before the next job
+                // that has no override of its own.
+                juce::MemoryBlock baseline;
+                plugin->getStateInformation(baseline);
+                bool overridden = false;
+
+                for (;;)
+                {
+                    const auto index = nextJob.fetch_add(1);
+                    if (index >= jobs.size())
+                        return;
+
+                    const auto& job = jobs[index];
+                    auto& result = results[index];
+
+                    if (job.state.getSize() > 0)
+                    {
+                        plugin->setStateInformation(job.state.getData(), static_cast<int>(job.state.getSize()));
+                        overridden = true;
+                    }
+                    else if (overridden)
+                    {
+                        plugin->setStateInformation(baseline.getData(), static_cast<int>(baseline.getSize()));
+                        overridden = false;
+                    }
+
+                    const double startMs = juce::Time::getMillisecondCounterHiRes();
+                    result.ok = OfflineProcessor::renderFile(*plugin, job.blockSize, job.input, job.output,
+                                                             result.error, nullptr, {}, job.bitDepth);
+                    result.seconds = (juce::Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+                }
+            });
+        }
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(10);
+    }
+
+    for (auto& instance : instances)
+        pluginHost.releaseInstance(std::move(instance));
+
+    juce::Array<juce::var> resultArray;
+    int numFailed = 0;
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        auto entry = std::make_unique<juce::DynamicObject>();
+        entry->setProperty("input", jobs[i].input.getFullPathName());
+        entry->setProperty("output", jobs[i].output.getFullPathName());
+        entry->setProperty("ok", results[i].ok);
+        entry->setProperty("seconds", results[i].seconds);
+        if (!results[i].ok)
+        {
+            entry->setProperty("error", results[i].error);
+            ++numFailed;
+            std::cerr << jobs[i].input.getFullPathName().toStdString() << ": "
+                      << results[i].error.toStdString() << "\n";
+        }
+        resultArray.add(juce::var(entry.release()));
+    }
+
+    const auto resultsFile = args.containsOption("--results")
+                                 ? resolvePathArgument(args.getValueForOption("--results"))
+                                 : manifestFile.getSiblingFile(manifestFile.getFileNameWithoutExtension() + "_results.json");
+    resultsFile.replaceWithText(juce::JSON::toString(juce::var(resultArray)));
+
+    std::cout << (jobs.size() - static_cast<size_t>(numFailed)) << "/" << jobs.size() << " ok, results: "
+              << resultsFile.getFullPathName().toStdString() << "\n";
+    return numFailed == 0 ? 0 : 1;
+}
+
+// Daemon mode: keeps the host and the loaded plugin resident and accepts
+// render jobs over a local TCP socket, so the Python tools stop paying
+// process startup, VST3 scan and plugin instantiation per file.
+//
+// Protocol: one JSON object per line, one JSON response per line.
+//   {"cmd":"load","plugin":"C:/x.vst3","blockSize":1024}
+//   {"cmd":"render","input":"a.wav","output":"b.wav"}
+//   {"cmd":"ping"}
+//   {"cmd":"quit"}
+class RenderServer final : private juce::Thread
+{
+public:
+    explicit RenderServer(int portToUse)
+        : juce::Thread("RenderServer"),
+          processor(pluginHost),
+          port(portToUse)
+    {
+    }
+
+    ~RenderServer() override
+    {
+        signalThreadShouldExit();
+        listener.close();
+        stopThread(5000);
+    }
+
+    bool start(juce::String& error)
+    {
+        if (!listener.createListener(port, "127.0.0.1"))
+        {
+            error = u8str(u8"\u65e0\u6cd5\u76d1\u542c\u7aef\u53e3 ") + juce::String(port);
+            return false;
+        }
+
+        startThread();
+        return true;
+    }
+
+    PluginHost& getPluginHost() { return pluginHost; }
+    OfflineProcessor& getProcessor() { return processor; }
+
+private:
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            std::unique_ptr<juce::StreamingSocket> client(listener.waitForNextConnection());
+            if (client != nullptr)
+                handleClient(*client);
+        }
+    }
+
+    void handleClient(juce::StreamingSocket& client)
+    {
+        juce::MemoryOutputStream lineBuffer;
+
+        while (!threadShouldExit())
+        {
+            const int ready = client.waitUntilReady(true, 200);
+            if (ready < 0)
+                return;
+            if (ready == 0)
+                continue;
+
+            char byte = 0;
+            if (client.read(&byte, 1, true) <= 0)
+                return;
+
+            if (byte != '\n')
+            {
+                lineBuffer.writeByte(byte);
+                continue;
+            }
+
+            const auto line = lineBuffer.toString().trim();
+            lineBuffer.reset();
+
+            if (line.isEmpty())
+                continue;
+
+            const auto response = juce::JSON::toString(handleRequest(line), true) + "\n";
+            const auto utf8 = response.toRawUTF8();
+            client.write(utf8, static_cast<int>(std::strlen(utf8)));
+        }
+    }
+
+    juce::var handleRequest(const juce::String& line)
+    {
+        const auto parsed = juce::JSON::parse(line);
+        if (parsed.getDynamicObject() == nullptr)
+            return makeResponse(false, u8str(u8"\u65e0\u6cd5\u89e3\u6790\u8bf7\u6c42 JSON"));
+
+        const auto cmd = parsed.getProperty("cmd", {}).toString();
+
+        if (cmd == "ping")
+            return makeResponse(true, {});
+
+        if (cmd == "load")
+        {
+            const auto pluginPath = parsed.getProperty("plugin", {}).toString();
+            const int blockSize = juce::jmax(64, static_cast<int>(parsed.getProperty("blockSize", 1024)));
+
+            // VST3 instantiation has to happen on the message thread.
+            juce::WaitableEvent done;
+            bool ok = false;
+            juce::String error;
+            juce::MessageManager::callAsync([this, &done, &ok, &error, pluginPath, blockSize]
+            {
+                ok = pluginHost.loadPluginFromFile(resolvePathArgument(pluginPath), 44100.0, blockSize, error);
+                done.signal();
+            });
+            done.wait();
+
+            if (!ok)
+                return makeResponse(false, error);
+
+            processor.setBlockSize(blockSize);
+            return makeResponse(true, {});
+        }
+
+        if (cmd == "render")
+        {
+            const auto inputPath = parsed.getProperty("input", {}).toString();
+            const auto outputPath = parsed.getProperty("output", {}).toString();
+
+            juce::String error;
+            OfflineProcessor::ProcessStats stats;
+            if (!processor.processAudioFileToFile(resolvePathArgument(inputPath), resolvePathArgument(outputPath), error, &stats))
+                return makeResponse(false, error);
+
+            auto response = makeResponse(true, {});
+            if (auto* obj = response.getDynamicObject())
+            {
+                obj->setProperty("outputChannels", stats.outputChannels);
+                obj->setProperty("inputRmsDb", stats.inputRmsDb);
+                obj->setProperty("diffRmsDb", stats.diffRmsDb);
+                obj->setProperty("maxAbsDiff", stats.maxAbsDiff);
+            }
+            return response;
+        }
+
+        if (cmd == "quit")
+        {
+            signalThreadShouldExit();
+            juce::MessageManager::callAsync([] { juce::JUCEApplication::getInstance()->systemRequestedQuit(); });
+            return makeResponse(true, {});
+        }
+
+        return makeResponse(false, u8str(u8"\u672a\u77e5\u547d\u4ee4\uff1a") + cmd);
+    }
+
+    static juce::var makeResponse(bool ok, const juce::String& error)
+    {
+        auto obj = std::make_unique<juce::DynamicObject>();
+        obj->setProperty("ok", ok);
+        if (error.isNotEmpty())
+            obj->setProperty("error", error);
+        return juce::var(obj.release());
+    }
+
+    PluginHost pluginHost;
+    OfflineProcessor processor;
+    juce::StreamingSocket listener;
+    int port;
+};
+
+// Batch mode: mirror every audio file under --in-dir into --out-dir through
+// the loaded plugin, spread across --jobs worker instances.
+
+// "Drop files in, get processed audio out": polls an input directory and
+// renders every new audio file through the loaded plugin into a mirror of
+// the tree under the output directory. A file is only picked up once its
+// size and modification time have been stable across two polls, so
+// half-copied files are never read. The watcher hands work to the render
+// workers over a small bounded queue and simply retries a full queue on the
+// next poll; the plugin and its warm instances stay resident for as long as
+// the service runs.
+class WatchFolderService final : private juce::Thread
+{
+public:
+    WatchFolderService(const juce::File& inputDirToUse,
+                       const juce::File& outputDirToUse,
+                       int numWorkersToUse,
+                       int blockSizeToUse,
+                       int bitDepthToUse)
+        : juce::Thread("WatchFolder"),
+          inputDir(inputDirToUse),
+          outputDir(outputDirToUse),
+          numWorkers(juce::jlimit(1, juce::SystemStats::getNumCpus(), numWorkersToUse)),
+          blockSize(blockSizeToUse),
+          bitDepth(bitDepthToUse)
+    {
+    }
+
+    ~WatchFolderService() override
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread(5000);
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queueFinished = true;
+        }
+        queueCondition.notify_all();
+
+        for (auto& worker : workers)
+            worker.join();
+
+        for (auto& instance : instances)
+            pluginHost.releaseInstance(std::move(instance));
+    }
+
+    PluginHost& getPluginHost() { return pluginHost; }
+
+    bool start(juce::String& error)
+    {
+        if (!inputDir.isDirectory())
+        {
+            error = u8str(u8"\u8f93\u5165\u76ee\u5f55\u4e0d\u5b58\u5728");
+            return false;
+        }
+
+        outputDir.createDirectory();
+
+        // One instance per worker, drawn from the warm pool. Instantiation
+        // is message-thread-only, so this happens here and not in the
+        // workers.
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            auto instance = pluginHost.acquireInstance(44100.0, blockSize, error);
+            if (instance == nullptr)
+                return false;
+            instances.push_back(std::move(instance));
+        }
+
+        for (auto& instance : instances)
+            workers.emplace_back([this, plugin = instance.get()] { workerLoop(*plugin); });
+
+        startThread();
+        return true;
+    }
+
+private:
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            scanOnce();
+            wait(1000);
+        }
+    }
+
+    void scanOnce()
+    {
+        for (const auto& entry : inputDir.findChildFiles(juce::File::findFiles, true, "*.wav;*.aiff;*.aif;*.flac;*.mp3"))
+        {
+            const auto path = entry.getFullPathName();
+            if (processedFiles.count(path) != 0)
+                continue;
+
+            // Outputs surviving a restart count as done.
+            if (outputFileFor(entry).existsAsFile())
+            {
+                processedFiles.insert(path);
+                continue;
+            }
+
+            const auto signature = std::make_pair(entry.getSize(),
+                                                  entry.getLastModificationTime().toMilliseconds());
+            const auto pending = pendingFiles.find(path);
+            if (pending == pendingFiles.end() || pending->second != signature)
+            {
+                pendingFiles[path] = signature; // first sighting, or still being written
+                continue;
+            }
+
+            if (tryEnqueue(entry))
+            {
+                processedFiles.insert(path);
+                pendingFiles.erase(path);
+            }
+        }
+    }
+
+    juce::File outputFileFor(const juce::File& input) const
+    {
+        return outputDir.getChildFile(input.getRelativePathFrom(inputDir)).withFileExtension("wav");
+    }
+
+    bool tryEnqueue(const juce::File& file)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (queue.size() >= maxQueuedJobs)
+                return false;
+
+            queue.push_back(file);
+        }
+
+        queueCondition.notify_one();
+        return true;
+    }
+
+    void workerLoop(juce::AudioPluginInstance& plugin)
+    {
+        for (;;)
+        {
+            juce::File inputFile;
+
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCondition.wait(lock, [this] { return queueFinished || !queue.empty(); });
+
+                if (queue.empty())
+                    return;
+
+                inputFile = queue.front();
+                queue.pop_front();
+            }
+
+            const auto outputFile = outputFileFor(inputFile);
+
+            juce::String error;
+            if (OfflineProcessor::renderFile(plugin, blockSize, inputFile, outputFile, error, nullptr, {}, bitDepth))
+                std::cout << inputFile.getFullPathName().toStdString()
+                          << " -> " << outputFile.getFullPathName().toStdString() << "\n";
+            else
+                std::cerr << inputFile.getFullPathName().toStdString()
+                          << ": " << error.toStdString() << "\n";
+        }
+    }
+
+    static constexpr size_t maxQueuedJobs = 64;
+
+    PluginHost pluginHost;
+    juce::File inputDir, outputDir;
+    int numWorkers;
+    int blockSize;
+    int bitDepth;
+
+    std::vector<std::unique_ptr<juce::AudioPluginInstance>> instances;
+    std::vector<std::thread> workers;
+
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<juce::File> queue;
+    bool queueFinished = false;
+
+    std::map<juce::String, std::pair<juce::int64, juce::int64>> pendingFiles; // path -> (size, mtime)
+    std::set<juce::String> processedFiles;
+};
+
+static int runHeadlessBatch(const juce::ArgumentList& args)
+{
+    const auto pluginPath = args.getValueForOption("--plugin");
+    const auto inDirPath = args.getValueForOption("--in-dir");
+    const auto outDirPath = args.getValueForOption("--out-dir");
+
+    if (pluginPath.isEmpty() || inDirPath.isEmpty() || outDirPath.isEmpty())
+    {
+        std::cerr << "Usage: VSTHostApp --plugin <plugin.vst3> --in-dir <dir> --out-dir <dir> [--jobs N] [--block-size N] [--state <state.bin>]\n";
+        return 2;
+    }
+
+    int blockSize = 1024;
+    if (args.containsOption("--block-size"))
+        blockSize = juce::jmax(64, args.getValueForOption("--block-size").getIntValue());
+
+    int numJobs = juce::SystemStats::getNumCpus();
+    if (args.containsOption("--jobs"))
+        numJobs = juce::jmax(1, args.getValueForOption("--jobs").getIntValue());
+
+    const auto inDir = resolvePathArgument(inDirPath);
+    if (!inDir.isDirectory())
+    {
+        std::cerr << u8str(u8"\u8f93\u5165\u76ee\u5f55\u4e0d\u5b58\u5728").toStdString() << "\n";
+        return 1;
+    }
+
+    const auto outDir = resolvePathArgument(outDirPath);
+
+    std::vector<BatchRenderer::Job> jobs;
+    for (const auto& entry : inDir.findChildFiles(juce::File::findFiles, true, "*.wav;*.aiff;*.aif;*.flac;*.mp3"))
+    {
+        const auto relative = entry.getRelativePathFrom(inDir);
+        jobs.push_back({ entry, outDir.getChildFile(relative).withFileExtension("wav") });
+    }
+
+    if (jobs.empty())
+    {
+        std::cerr << u8str(u8"\u76ee\u5f55\u4e2d\u6ca1\u6709\u53ef\u5904\u7406\u7684\u97f3\u9891\u6587\u4ef6").toStdString() << "\n";
+        return 1;
+    }
+
+    juce::File stateFile;
+    if (args.containsOption("--state"))
+        stateFile = resolvePathArgument(args.getValueForOption("--state"));
+
+    PluginHost pluginHost;
+    juce::String error;
+    if (!pluginHost.loadPluginFromFile(resolvePathArgument(pluginPath), 44100.0, blockSize, error, stateFile))
+    {
+        std::cerr << error.toStdString() << "\n";
+        return 1;
+    }
+
+    BatchRenderer renderer(pluginHost, numJobs);
+    std::vector<BatchRenderer::Result> results;
+    if (!renderer.renderAll(jobs, blockSize, results, error))
+    {
+        std::cerr << error.toStdString() << "\n";
+        return 1;
+    }
+
+    int numFailed = 0;
+    for (const auto& result : results)
+    {
+        if (!result.ok)
+        {
+            ++numFailed;
+            std::cerr << result.input.getFullPathName().toStdString() << ": " << result.error.toStdString() << "\n";
+        }
+    }
+
+    std::cout << (results.size() - static_cast<size_t>(numFailed)) << "/" << results.size() << " ok\n";
+    return numFailed == 0 ? 0 : 1;
+}
+} // namespace vsthost
+
+class VSTHostApplication final : public juce::JUCEApplication
+{
+public:
+    const juce::String getApplicationName() override { return "VSTHostApp"; }
+    const juce::String getApplicationVersion() override { return "0.1.0"; }
+    bool moreThanOneInstanceAllowed() override { return true; }
+
+    void initialise(const juce::String& commandLine) override
+    {
+        const juce::ArgumentList args(juce::File::getSpecialLocation(juce::File::currentExecutableFile).getFullPathName(),
+                                      commandLine);
+
+        if (args.containsOption("--watch"))
+        {
+            const auto inDirPath = args.getValueForOption("--watch");
+            const auto outDirPath = args.getValueForOption("--out-dir");
+            const auto pluginPath = args.getValueForOption("--plugin");
+
+            if (inDirPath.isEmpty() || outDirPath.isEmpty() || pluginPath.isEmpty())
+            {
+                std::cerr << "Usage: VSTHostApp --watch <in-dir> --out-dir <dir> --plugin <plugin.vst3> [--jobs N] [--block-size N] [--bit-depth 16|24|32] [--state <state.bin>]\n";
+                setApplicationReturnValue(2);
+                quit();
+                return;
+            }
+
+            int blockSize = 1024;
+            if (args.containsOption("--block-size"))
+                blockSize = juce::jmax(64, args.getValueForOption("--block-size").getIntValue());
+
+            int bitDepth = 24;
+            if (args.containsOption("--bit-depth"))
+                bitDepth = args.getValueForOption("--bit-depth").getIntValue();
+
+            int numJobs = 2;
+            if (args.containsOption("--jobs"))
+                numJobs = juce::jmax(1, args.getValueForOption("--jobs").getIntValue());
+
+            juce::String error;
+            if (!vsthost::OfflineProcessor::isSupportedBitDepth(bitDepth))
+            {
+                std::cerr << u8str(u8"\u4e0d\u652f\u6301\u7684\u8f93\u51fa\u4f4d\u6df1\u5ea6\uff08\u4ec5\u652f\u6301 16/24/32\uff09").toStdString() << "\n";
+                setApplicationReturnValue(2);
+                quit();
+                return;
+            }
+
+            watchService = std::make_unique<vsthost::WatchFolderService>(
+                vsthost::resolvePathArgument(inDirPath), vsthost::resolvePathArgument(outDirPath),
+                numJobs, blockSize, bitDepth);
+
+            juce::File stateFile;
+            if (args.containsOption("--state"))
+                stateFile = vsthost::resolvePathArgument(args.getValueForOption("--state"));
+
+            if (!watchService->getPluginHost().loadPluginFromFile(
+                    vsthost::resolvePathArgument(pluginPath), 44100.0, blockSize, error, stateFile)
+                || !watchService->start(error))
+            {
+                std::cerr << error.toStdString() << "\n";
+                setApplicationReturnValue(1);
+                quit();
+            }
+            return;
+        }
+
+        if (args.containsOption("--serve"))
+        {
+            int port = 53917;
+            if (args.containsOption("--port"))
+                port = args.getValueForOption("--port").getIntValue();
+
+            renderServer = std::make_unique<vsthost::RenderServer>(port);
+
+            juce::String error;
+
+            // Optional preload, so the first render job is already warm.
+            if (args.containsOption("--plugin"))
+            {
+                int blockSize = 1024;
+                if (args.containsOption("--block-size"))
+                    blockSize = juce::jmax(64, args.getValueForOption("--block-size").getIntValue());
+
+                juce::File stateFile;
+                if (args.containsOption("--state"))
+                    stateFile = vsthost::resolvePathArgument(args.getValueForOption("--state"));
+
+                if (!renderServer->getPluginHost().loadPluginFromFile(
+                        vsthost::resolvePathArgument(args.getValueForOption("--plugin")), 44100.0, blockSize, error, stateFile))
+                {
+                    std::cerr << error.toStdString() << "\n";
+                    setApplicationReturnValue(1);
+                    quit();
+                    return;
+                }
+
+                renderServer->getProcessor().setBlockSize(blockSize);
+
+                // Optional warm pool, so parallel/batch jobs arriving over
+                // the socket skip cold instantiation entirely.
+                if (args.containsOption("--prewarm"))
+                {
+                    const int prewarmCount = juce::jmax(1, args.getValueForOption("--prewarm").getIntValue());
+                    if (!renderServer->getPluginHost().prewarmInstances(prewarmCount, 44100.0, blockSize, error))
+                    {
+                        std::cerr << error.toStdString() << "\n";
+                        setApplicationReturnValue(1);
+                        quit();
+                        return;
+                    }
+                }
+            }
+
+            if (!renderServer->start(error))
+            {
+                std::cerr << error.toStdString() << "\n";
+                setApplicationReturnValue(1);
+                quit();
+            }
+            return;
+        }
+
+        if (args.containsOption("--midi"))
+        {
+            setApplicationReturnValue(vsthost::runHeadlessMidiRender(args));
+            quit();
+            return;
+        }
+
+        if (args.containsOption("--manifest"))
+        {
+            setApplicationReturnValue(vsthost::runHeadlessManifest(args));
+            quit();
+            return;
+        }
+
+        if (args.containsOption("--in-dir"))
+        {
+            setApplicationReturnValue(vsthost::runHeadlessBatch(args));
+            quit();
+            return;
+        }
+
+        if (args.containsOption("--plugin"))
+        {
+            setApplicationReturnValue(vsthost::runHeadlessRender(args));
+            quit();
+            return;
+        }
+
         mainWindow = std::make_unique<MainWindow>(getApplicationName());
     }
 
     void shutdown() override
     {
+        watchService = nullptr;
+        renderServer = nullptr;
         mainWindow = nullptr;
     }
 
@@ -1256,6 +2448,8 @@ private:
     };
 
     std::unique_ptr<MainWindow> mainWindow;
+    std::unique_ptr<vsthost::RenderServer> renderServer;
+    std::unique_ptr<vsthost::WatchFolderService> watchService;
 };
 
 START_JUCE_APPLICATION(VSTHostApplication)
@@ -68,6 +68,8 @@ function applyState(s) {
   el("inPath").textContent = s.inputPath || "";
   el("outPath").textContent = s.outputPath || "";
   el("blockSize").value = (s.blockSize || 1024).toString();
+  el("bitDepth").value = (s.bitDepth || 24).toString();
+  if (s.statsEnabled !== undefined) el("statsToggle").checked = !!s.statsEnabled;
 }
 
 async function refresh() {
@@ -97,6 +99,30 @@ el("applyBlockBtn").addEventListener("click", async () => {
   }
 });
 
+el("bitDepth").addEventListener("change", async () => {
+  try {
+    const depth = parseInt(el("bitDepth").value, 10);
+    const s = await callNative("setBitDepth", [depth]);
+    if (s.ok === false) throw new Error(s.error || "设置失败");
+    applyState(s);
+    setStatus("位深已应用", true);
+  } catch (e) {
+    setStatus("错误", false);
+    logLine(e.message || String(e), "ERR");
+  }
+});
+
+el("statsToggle").addEventListener("change", async () => {
+  try {
+    const s = await callNative("setStatsEnabled", [el("statsToggle").checked]);
+    if (s.ok === false) throw new Error(s.error || "设置失败");
+    applyState(s);
+  } catch (e) {
+    setStatus("错误", false);
+    logLine(e.message || String(e), "ERR");
+  }
+});
+
 el("choosePluginBtn").addEventListener("click", async () => {
   try {
     const s = await callNative("choosePlugin");
@@ -110,6 +136,19 @@ el("choosePluginBtn").addEventListener("click", async () => {
   }
 });
 
+el("addChainBtn").addEventListener("click", async () => {
+  try {
+    const s = await callNative("addPluginToChain");
+    if (s.ok === false) throw new Error(s.error || "加载失败");
+    applyState(s);
+    setStatus("已追加到链", true);
+    logLine("插件链: " + (s.pluginName || ""), "OK");
+  } catch (e) {
+    setStatus("错误", false);
+    logLine(e.message || String(e), "ERR");
+  }
+});
+
 el("openEditorBtn").addEventListener("click", async () => {
   try {
     const r = await callNative("openPluginEditor");
@@ -121,6 +160,32 @@ el("openEditorBtn").addEventListener("click", async () => {
   }
 });
 
+el("saveStateBtn").addEventListener("click", async () => {
+  try {
+    const s = await callNative("savePluginState");
+    if (s.ok === false) throw new Error(s.error || "保存失败");
+    applyState(s);
+    setStatus("状态已保存", true);
+    logLine("插件状态已保存", "OK");
+  } catch (e) {
+    setStatus("错误", false);
+    logLine(e.message || String(e), "ERR");
+  }
+});
+
+el("loadStateBtn").addEventListener("click", async () => {
+  try {
+    const s = await callNative("loadPluginState");
+    if (s.ok === false) throw new Error(s.error || "加载失败");
+    applyState(s);
+    setStatus("状态已加载", true);
+    logLine("插件状态已加载", "OK");
+  } catch (e) {
+    setStatus("错误", false);
+    logLine(e.message || String(e), "ERR");
+  }
+});
+
 el("chooseInBtn").addEventListener("click", async () => {
   try {
     const s = await callNative("chooseInputAudio");
@@ -157,6 +222,17 @@ el("startBtn").addEventListener("click", async () => {
       logLine("输入 RMS (dB): " + r.stats.inputRmsDb.toFixed(2), "OK");
       logLine("差异 RMS (dB): " + r.stats.diffRmsDb.toFixed(2), "OK");
       logLine("最大差异: " + r.stats.maxAbsDiff.toFixed(6), "OK");
+      logLine("输出峰值: " + r.stats.outputPeak.toFixed(4) + "，超限采样数: " + r.stats.clippedSamples, "OK");
+      if (r.stats.timing) {
+        for (const [stage, t] of Object.entries(r.stats.timing)) {
+          logLine(
+            "阶段 " + stage + ": 总计 " + t.totalMs.toFixed(0) + " ms, p50 " +
+              t.p50Ms.toFixed(3) + " ms, p99 " + t.p99Ms.toFixed(3) + " ms, 最大 " +
+              t.maxMs.toFixed(3) + " ms",
+            "OK"
+          );
+        }
+      }
     }
     if (r.outputPath) logLine("输出: " + r.outputPath, "OK");
     await refresh();
@@ -166,14 +242,50 @@ el("startBtn").addEventListener("click", async () => {
   }
 });
 
+// 二进制数组通道：float32 以 base64 跨桥传输，避免原来每个样本的字符串解析/拼接。
+function parseFloatText(text) {
+  const tokens = text.split(/[\s,;]+/).filter(Boolean);
+  const out = new Float32Array(tokens.length);
+  for (let i = 0; i < tokens.length; i++) {
+    const v = Number(tokens[i]);
+    if (!Number.isFinite(v)) throw new Error("输入数组中包含非数值内容");
+    out[i] = v;
+  }
+  return out;
+}
+
+function floatsToBase64(floats) {
+  const bytes = new Uint8Array(floats.buffer, floats.byteOffset, floats.byteLength);
+  let binary = "";
+  const chunk = 0x8000;
+  for (let i = 0; i < bytes.length; i += chunk) {
+    binary += String.fromCharCode.apply(null, bytes.subarray(i, i + chunk));
+  }
+  return btoa(binary);
+}
+
+function base64ToFloats(b64) {
+  const binary = atob(b64);
+  const bytes = new Uint8Array(binary.length);
+  for (let i = 0; i < binary.length; i++) bytes[i] = binary.charCodeAt(i);
+  return new Float32Array(bytes.buffer);
+}
+
+function formatFloats(floats) {
+  const parts = new Array(floats.length);
+  for (let i = 0; i < floats.length; i++) parts[i] = floats[i].toFixed(7);
+  return parts.join(",\n");
+}
+
 el("processArrayBtn").addEventListener("click", async () => {
   try {
     const sr = parseFloat(el("sampleRate").value || "44100");
-    const text = el("arrayIn").value || "";
+    const input = parseFloatText(el("arrayIn").value || "");
+    if (input.length === 0) throw new Error("请输入至少一个 float");
     setStatus("处理中…", true);
-    const r = await callNative("processArray", [sr, text]);
+    const r = await callNative("processArrayBinary", [sr, floatsToBase64(input)]);
     if (r.ok === false) throw new Error(r.error || "处理失败");
-    el("arrayOut").value = r.outputText || "";
+    el("arrayOut").value = formatFloats(base64ToFloats(r.outputBase64 || ""));
     setStatus("数组处理完成", true);
   } catch (e) {
     setStatus("错误", false);